@@ -33,6 +33,7 @@
 /*************************************************************************************/
 
 #include "term.h"
+#include "stream.h"
 
 namespace Olly {
 
@@ -43,26 +44,78 @@ namespace Olly {
     //          The expression class is implemented using Lisp inspired data nodes.  It
     //          is used to define the data sets as in Lisp.  
     //
+    //          The elements are held as the real time deque of Okasaki.  The leading
+    //          elements are held in one 'stream', and the trailing elements in another,
+    //          last first.  When either grows longer than 'balance_limit' times the
+    //          other, plus one, half of it is rotated onto the other lazily.  Each
+    //          operation then forces a cell or two of each rotation, so every one is
+    //          finished before the next is needed.  Joining, linking, and removing an
+    //          element at either end, and reading either end, are all constant time
+    //          in the worst case, not only on average, and however each version is
+    //          shared.  That bound counts the cells each operation forces, not those it
+    //          releases.  A rotation finished or a version dropped releases every cell
+    //          only it references, in place with the default 'reclaimer', so the bound
+    //          holds for releasing as well only once 'reclaimer::incremental' or
+    //          'reclaimer::start' is called.
+    //
+    //          An expression built from a range conses the cells of each stream
+    //          directly, half the elements in each, so nothing is rotated.  Appending
+    //          or prepending a range conses its elements onto one stream and balances
+    //          once at the end, each linear in the length of the range.
+    //
+    //          The '_op_' functions taking a mutable expression are called by the
+    //          rvalue operations of 'var', when only that 'var' references it.  They
+    //          change it in place, rather than copying it for the result.
+    //
+    //          Defining OLLY_CACHED_HASH caches the hashes of the streams in their
+    //          cells, so an expression sharing most of its cells with one already
+    //          hashed only hashes the cells it adds.
+    //
     /********************************************************************************************/
 
     class expression {
 
-        var _lead;
-        var _last;
+        var         _lead;            // The leading elements, first element first.
+        var         _last;            // The trailing elements, last element first.
+        var         _lead_schedule;   // The cells of '_lead' still to be forced.
+        var         _last_schedule;   // The cells of '_last' still to be forced.
+        std::size_t _lead_size;
+        std::size_t _last_size;
+
+        static const std::size_t balance_limit = stream::rotation_step;
 
-        static const std::size_t balance_limit = 2;
+        template <typename I, typename S>
+        void append(I first, S last);
+        template <typename I, typename S>
+        void prepend(I first, S last);
 
     public:
 
+        class builder;
+
         expression();
         expression(var x);
         template<typename T, typename... Args>
         expression(T x, Args... args);
+        template <typename R>
+        expression(from_range_t, R&& range);
+        template <typename I, typename S>
+            requires std::input_iterator<I> && std::sentinel_for<S, I> && (!std::convertible_to<I, Text>)
+        expression(I first, S last);
+        expression(const expression& other);
+        expression(expression&& other) noexcept;
         virtual ~expression();
 
+        template <typename F> void           each(F&& f)   const;  // Call 'f' with each element, in order.
+        template <typename F> void  each_reversed(F&& f)   const;  // Call 'f' with each element, last first.
+
+        template <typename R> void   append_range(R&& range);  // Link the elements of 'range', in order.
+        template <typename R> void  prepend_range(R&& range);  // Join the elements of 'range', keeping their order.
+
         friend Text           _type_(const expression& self);
         friend bool             _is_(const expression& self);
         friend double         _comp_(const expression& self, const var& other);
+        friend bool         _equals_(const expression& self, const var& other);
 
         friend void            _str_(Text_Stream& out, const expression& self);
         friend void           _repr_(Text_Stream& out, const expression& self);
@@ -71,20 +124,77 @@ namespace Olly {
         friend var            _lead_(const expression& self);
         friend var            _last_(const expression& self);
         friend var            _join_(const expression& self, const var& other);
+        friend var            _join_(const expression& self, var&& other);
+        friend void           _join_(expression& self, var&& other);
         friend var            _link_(const expression& self, const var& other);
+        friend var            _link_(const expression& self, var&& other);
+        friend void           _link_(expression& self, var&& other);
         friend var            _next_(const expression& self);
+        friend void           _next_(expression& self);
         friend var            _prev_(const expression& self);
+        friend void           _prev_(expression& self);
         friend var         _reverse_(const expression& self);
+        friend std::size_t    _hash_(const expression& self);
 
         friend var             _add_(const expression& self, const var& other);
 
         template<typename... Args>
         void link(const var& other, Args... args);
         void link(const var& other);
+        void link(var&& other);
         void link();
 
+        void join(var&& other);
+
+        void next();
+        void prev();
+
+        void schedule(std::size_t cells);  // Force the next cells of each rotation.
         void balance();
-        void balance(var& a, var& b);
+    };
+
+    /********************************************************************************************/
+    //
+    //                               'expression::builder' Class Definition
+    //
+    //          A builder is a transient expression, in the manner of Clojure.  It
+    //          changes the cells only it references in place, rather than copying
+    //          the expression for each element.  When either stream grows too long,
+    //          half of it is relinked onto the other at once, rather than rotated
+    //          lazily, so no cell is allocated but for the elements added.  Calling
+    //          'freeze' moves the streams into an expression in constant time, and
+    //          leaves the builder empty.
+    //
+    //          A builder begun from an expression shares its cells, which are copied
+    //          instead the first time they would be changed.  A builder is not safe
+    //          to use from more than one thread at a time.
+    //
+    /********************************************************************************************/
+
+    class expression::builder {
+
+        expression _expression;
+
+        static void rotate(var& from, std::size_t keep, var& onto);  // Keep the first cells of 'from', and move the rest onto the end of 'onto'.
+
+        void balance();
+
+    public:
+
+        builder();
+        explicit builder(const expression& x);
+
+        std::size_t size() const;
+
+        void join(var x);
+        void link(var x);
+        void next();
+        void prev();
+
+        template <typename R> void   append_range(R&& range);  // Link the elements of 'range', in order.
+        template <typename R> void  prepend_range(R&& range);  // Join the elements of 'range', keeping their order.
+
+        var freeze();  // The expression built, leaving the builder empty.
     };
 
     /********************************************************************************************/
@@ -93,133 +203,255 @@ namespace Olly {
     //
     /********************************************************************************************/
 
-    expression::expression() : _lead(term()), _last(term()) {
+    expression::expression()
+        : _lead(), _last(), _lead_schedule(), _last_schedule(), _lead_size(0), _last_size(0) {
     }
 
-    expression::expression(var x) : _lead(term()), _last(term(x)) {
+    expression::expression(var x) : expression() {
+
+        link(std::move(x));
     }
 
     template<typename T, typename... Args>
-    expression::expression(T x, Args... args) : _lead(term()), _last(term()) {
+    expression::expression(T x, Args... args) : expression() {
 
         link(x);
         link(args...);
     }
 
+    template <typename R>
+    expression::expression(from_range_t, R&& range) : expression() {
+
+        append(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    template <typename I, typename S>
+        requires std::input_iterator<I> && std::sentinel_for<S, I> && (!std::convertible_to<I, Text>)
+    expression::expression(I first, S last) : expression() {
+        /*
+            Pointers to characters are left to the constructor
+            above, as text rather than the ends of a range.
+        */
+
+        append(std::move(first), std::move(last));
+    }
+
+    expression::expression(const expression& other)
+        : _lead(other._lead), _last(other._last),
+          _lead_schedule(other._lead_schedule), _last_schedule(other._last_schedule),
+          _lead_size(other._lead_size), _last_size(other._last_size) {
+    }
+
+    expression::expression(expression&& other) noexcept
+        : _lead(std::move(other._lead)), _last(std::move(other._last)),
+          _lead_schedule(std::move(other._lead_schedule)), _last_schedule(std::move(other._last_schedule)),
+          _lead_size(other._lead_size), _last_size(other._last_size) {
+    }
+
     expression::~expression() {
     }
 
+    template <typename F>
+    void expression::each(F&& f) const {
+        /*
+            The elements of '_last' are held in reverse, and are
+            visited backwards in place rather than reversed.
+        */
+
+        auto lead = stream::force(_lead);
+        auto last = stream::force(_last);
+
+        if (lead) {
+            lead->each(f);
+        }
+
+        if (last) {
+            last->each_reversed(f);
+        }
+    }
+
+    template <typename F>
+    void expression::each_reversed(F&& f) const {
+
+        auto lead = stream::force(_lead);
+        auto last = stream::force(_last);
+
+        if (last) {
+            last->each(f);
+        }
+
+        if (lead) {
+            lead->each_reversed(f);
+        }
+    }
+
+    template <typename R>
+    void expression::append_range(R&& range) {
+
+        append(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    template <typename R>
+    void expression::prepend_range(R&& range) {
+
+        prepend(std::ranges::begin(range), std::ranges::end(range));
+    }
+
     std::string _type_(const expression& self) {
         return "expression";
     }
 
     bool _is_(const expression& self) {
-        return self._lead.size() || self._last.size();
+        return self._lead_size || self._last_size;
     }
 
     double _comp_(const expression& self, const var& other) {
+        return _equals_(self, other) ? 0.0 : NOT_A_NUMBER;
+    }
+
+    bool _equals_(const expression& self, const var& other) {
 
         auto ptr = other.cast<expression>();
 
         if (ptr) {
 
-            return self._lead == ptr->_lead && self._last == ptr->_last;
-        }
+            if (&self == ptr.get()) {
+                return true;
+            }
 
-        return NOT_A_NUMBER;
-    }
+            if (_size_(self) != _size_(*ptr)) {
+                return false;
+            }
 
-    void _str_(Text_Stream& out, const expression& self) {
+#if defined(OLLY_CACHED_HASH)
+            if (stream::hashed(self._lead) && stream::hashed(self._last) &&
+                stream::hashed(ptr->_lead) && stream::hashed(ptr->_last) && _hash_(self) != _hash_(*ptr)) {
+                return false;
+            }
+#endif
+            /*
+                The leading streams are walked from the first element,
+                and the trailing streams from the last, in lockstep.
+                The walk stops at the first difference, or once both
+                reach the same cell, as the rest is then shared.  The
+                elements left between are in the longer leading stream
+                of one, and deeper in the longer trailing stream of the
+                other, which is walked backwards.
+            */
+
+            auto lockstep = [](const stream*& a, const stream*& b, std::size_t n) {
+
+                for (; n && a && b; --n) {
+
+                    if (a == b) {
+                        return true;
+                    }
+
+                    if (!a->head().equals(b->head())) {
+                        return false;
+                    }
+
+                    a = stream::force(a->tail());
+                    b = stream::force(b->tail());
+                }
+
+                return true;
+            };
+
+            const stream* lead_a = stream::force(self._lead);
+            const stream* lead_b = stream::force(ptr->_lead);
+            const stream* last_a = stream::force(self._last);
+            const stream* last_b = stream::force(ptr->_last);
+
+            if (!lockstep(lead_a, lead_b, std::min(self._lead_size, ptr->_lead_size)) ||
+                !lockstep(last_a, last_b, std::min(self._last_size, ptr->_last_size))) {
+                return false;
+            }
 
-        if (!_is_(self)) {
-            out << "()";
-            return;
-        }
+            const stream* forward  = self._lead_size > ptr->_lead_size ? lead_a : lead_b;
+            const stream* backward = self._lead_size > ptr->_lead_size ? last_b : last_a;
 
-        out << "(";
+            const std::size_t middle = self._lead_size > ptr->_lead_size ? self._lead_size - ptr->_lead_size
+                                                                         : ptr->_lead_size - self._lead_size;
+
+            if (!middle || !forward || !backward) {
+                return true;
+            }
 
-        var e(self._lead);
+            return backward->all_reversed(middle, [&](const var& x) {
 
-        while (e.is()) {
-            e.lead().str(out);
+                bool same = forward && forward->head().equals(x);
 
-            e = e.next();
+                forward = same ? stream::force(forward->tail()) : nullptr;
 
-            out << " ";
+                return same;
+            });
         }
 
-        e = self._last.reverse();
+        return false;
+    }
+
+    void _str_(Text_Stream& out, const expression& self) {
 
-        while (e.is()) {
-            e.lead().str(out);
+        out << "(";
 
-            e = e.next();
+        const char* separator = "";  // Written before every element but the first.
 
-            out << " ";
-        }
+        self.each([&](const var& x) {
+            out << separator;
+
+            x.str(out);
 
-        out.seekp(-1, out.cur);
+            separator = " ";
+        });
 
         out << ")";
     }
 
     void _repr_(Text_Stream& out, const expression& self) {
 
-        if (!_is_(self)) {
-            out << "()";
-            return;
-        }
-
         out << "(";
 
-        var e(self._lead);
-
-        while (e.is()) {
-            e.lead().repr(out);
+        const char* separator = "";  // Written before every element but the first.
 
-            e = e.next();
+        self.each([&](const var& x) {
+            out << separator;
 
-            out << " ";
-        }
-
-        e = self._last.reverse();
-
-        while (e.is()) {
-            e.lead().repr(out);
-
-            e = e.next();
-
-            out << " ";
-        }
+            x.repr(out);
 
-        out.seekp(-1, out.cur);
+            separator = " ";
+        });
 
         out << ")";
     }
 
     std::size_t _size_(const expression& self) {
-        return self._lead.size() + self._last.size();
+        return self._lead_size + self._last_size;
     }
 
     var _lead_(const expression& self) {
+        /*
+            Either stream is only empty if the other holds
+            no more than one element.
+        */
 
-        if (self._lead.is()) {
-            return self._lead.lead();
-        }
+        auto x = stream::force(self._lead_size ? self._lead : self._last);
 
-        return self._last.reverse().lead();
+        return x ? x->head() : var();
     }
 
     var _last_(const expression& self) {
 
-        if (self._last.is()) {
-            return self._last.lead();
-        }
+        auto x = stream::force(self._last_size ? self._last : self._lead);
 
-        return self._lead.reverse().lead();
+        return x ? x->head() : var();
     }
 
     var _join_(const expression& self, const var& other) {
+        return _join_(self, var(other));
+    }
+
+    var _join_(const expression& self, var&& other) {
 
         if (other.is_nothing()) {
             return self;
@@ -227,20 +459,25 @@ namespace Olly {
 
         expression a{ self };
 
-        if (!a._last.is()) {
+        a.join(std::move(other));
 
-            a._last = a._last.join(other);
-        }
-        else {
-            a._lead = a._lead.join(other);
-        }
+        return a;
+    }
 
-        a.balance();
+    void _join_(expression& self, var&& other) {
+        /*
+            The hash cached is forgotten along with the elements
+            it was computed from.
+        */
 
-        return a;
+        self.join(std::move(other));
     }
 
     var _link_(const expression& self, const var& other) {
+        return _link_(self, var(other));
+    }
+
+    var _link_(const expression& self, var&& other) {
 
         if (other.is_nothing()) {
             return self;
@@ -248,17 +485,16 @@ namespace Olly {
 
         expression a{ self };
 
-        if (!a._lead.is()) {
-
-            a._lead = a._lead.join(other);
-        }
-        else {
-            a.link(other);
-        }
+        a.link(std::move(other));
 
         return a;
     }
 
+    void _link_(expression& self, var&& other) {
+
+        self.link(std::move(other));
+    }
+
     var _next_(const expression& self) {
 
         if (!_is_(self)) {
@@ -267,16 +503,16 @@ namespace Olly {
 
         expression a{ self };
 
-        a.balance();
+        a.next();
 
-        if (!a._lead.is()) {
-
-            a._lead = a._lead.join(pop_lead(a._last));
-        }
+        return a;
+    }
 
-        a._lead = a._lead.next();
+    void _next_(expression& self) {
 
-        return a;
+        if (_is_(self)) {
+            self.next();
+        }
     }
 
     var _prev_(const expression& self) {
@@ -287,16 +523,16 @@ namespace Olly {
 
         expression a{ self };
 
-        a.balance();
-
-        if (!a._last.is()) {
+        a.prev();
 
-            a._last = a._last.join(pop_lead(a._lead));
-        }
+        return a;
+    }
 
-        a._last = a._last.next();
+    void _prev_(expression& self) {
 
-        return a;
+        if (_is_(self)) {
+            self.prev();
+        }
     }
 
     var _reverse_(const expression& self) {
@@ -304,23 +540,53 @@ namespace Olly {
         expression a{ self };
 
         std::swap(a._lead, a._last);
+        std::swap(a._lead_schedule, a._last_schedule);
+        std::swap(a._lead_size, a._last_size);
 
         return a;
     }
 
+    std::size_t _hash_(const expression& self) {
+        /*
+            Fold the hash of each element in order, so equal
+            expressions hash equally however they are split.
+        */
+
+#if defined(OLLY_CACHED_HASH)
+        /*
+            The elements in order are the leading stream followed
+            by the trailing one reversed, so the fold is built from
+            the hashes cached in the cells of each.
+
+                H = R(last) + (H(lead) - seed) * B^|last|
+        */
+
+        auto lead = stream::hash(self._lead);
+        auto last = stream::hash(self._last);
+
+        return last.reverse + (lead.hash - hash_seed) * last.power;
+#else
+        std::uint64_t h = hash_seed;
+
+        self.each([&](const var& x) {
+            h = hash_combine(h, x.hash());
+        });
+
+        return h;
+#endif
+    }
+
     var _add_(const expression& self, const var& other) {
 
         auto ptr = other.cast<expression>();
 
         if (ptr) {
 
-            var a{ self };
-            var b{ *ptr };
-
-            while (b.is()) {
+            expression a{ self };
 
-                a = a.link(pop_lead(b));
-            }
+            ptr->each([&](const var& x) {
+                a.link(x);
+            });
 
             return a;
         }
@@ -337,51 +603,417 @@ namespace Olly {
     }
 
     void expression::link(const var& other) {
+        link(var(other));
+    }
 
-        _last = _last.join(other);
+    void expression::link(var&& other) {
 
+        if (other.is_nothing()) {
+            return;
+        }
+
+        _last = stream::cons(std::move(other), std::move(_last));
+        _last_size += 1;
+
+        schedule(1);
         balance();
     }
 
     void expression::link() {
     }
 
-    void expression::balance() {
+    void expression::join(var&& other) {
+
+        if (other.is_nothing()) {
+            return;
+        }
 
-        if ((_lead.size() / balance_limit) > _last.size()) {
+        _lead = stream::cons(std::move(other), std::move(_lead));
+        _lead_size += 1;
 
-            balance(_last, _lead);
+        schedule(1);
+        balance();
+    }
+
+    void expression::next() {
+
+        if (!_lead_size) {
+            /*
+                The other stream holds the only element.
+            */
+
+            _last          = var();
+            _last_schedule = var();
+            _last_size     = 0;
+
+            return;
         }
 
-        else if ((_last.size() / balance_limit) > _lead.size()) {
+        _lead = stream::advance(_lead);
+        _lead_size -= 1;
 
-            balance(_lead, _last);
+        schedule(2);
+        balance();
+    }
+
+    void expression::prev() {
+
+        if (!_last_size) {
+            /*
+                The other stream holds the only element.
+            */
+
+            _lead          = var();
+            _lead_schedule = var();
+            _lead_size     = 0;
+
+            return;
         }
+
+        _last = stream::advance(_last);
+        _last_size -= 1;
+
+        schedule(2);
+        balance();
     }
 
-    void expression::balance(var& a, var& b) {
+    template <typename I, typename S>
+    void expression::append(I first, S last) {
+
+        if (!_is_(*this)) {
+            /*
+                Cons the first half onto the leading stream from
+                the middle back, and the rest onto the trailing
+                stream, so both are already balanced.  A range
+                which can only be walked forward is copied before.
+            */
+
+            if constexpr (std::bidirectional_iterator<I> && std::same_as<I, S>) {
 
-        std::vector<var> buffer;
+                const I middle = std::next(first, std::distance(first, last) / 2);
 
-        auto limit = (b.size() / balance_limit);
+                for (I i = middle; i != first;) {
 
-        while (limit--) {
+                    var x(*--i);
 
-            buffer.push_back(pop_lead(b));
+                    if (x.is_something()) {
+                        _lead = stream::cons(std::move(x), std::move(_lead));
+                        _lead_size += 1;
+                    }
+                }
+
+                for (I i = middle; i != last; ++i) {
+
+                    var x(*i);
+
+                    if (x.is_something()) {
+                        _last = stream::cons(std::move(x), std::move(_last));
+                        _last_size += 1;
+                    }
+                }
+            }
+            else {
+
+                std::vector<var> elements;
+
+                for (; first != last; ++first) {
+                    elements.emplace_back(*first);
+                }
+
+                append(elements.begin(), elements.end());
+            }
         }
+        else {
 
-        var t = a.reverse();
+            std::size_t count = 0;
 
-        a = b.reverse();
-        b = term();
+            for (; first != last; ++first) {
 
-        for (auto i = buffer.crbegin(); i != buffer.crend(); ++i) {
+                var x(*first);
 
-            b = b.join(*i);
+                if (x.is_something()) {
+                    _last = stream::cons(std::move(x), std::move(_last));
+                    count += 1;
+                }
+            }
+
+            _last_size += count;
+
+            schedule(count);
         }
 
-        while (t.is()) {
-            a = a.join(pop_lead(t));
+        balance();
+    }
+
+    template <typename I, typename S>
+    void expression::prepend(I first, S last) {
+        /*
+            The elements are joined last first, so a range which
+            can only be walked forward is copied before.
+        */
+
+        if (!_is_(*this)) {
+            append(std::move(first), std::move(last));
         }
+
+        else if constexpr (std::bidirectional_iterator<I> && std::same_as<I, S>) {
+
+            std::size_t count = 0;
+
+            while (last != first) {
+
+                var x(*--last);
+
+                if (x.is_something()) {
+                    _lead = stream::cons(std::move(x), std::move(_lead));
+                    count += 1;
+                }
+            }
+
+            _lead_size += count;
+
+            schedule(count);
+            balance();
+        }
+        else {
+
+            std::vector<var> elements;
+
+            for (; first != last; ++first) {
+                elements.emplace_back(*first);
+            }
+
+            prepend(elements.begin(), elements.end());
+        }
+    }
+
+    /********************************************************************************************/
+    //
+    //                               'expression::builder' Class Implementation
+    //
+    /********************************************************************************************/
+
+    expression::builder::builder() : _expression() {
+    }
+
+    expression::builder::builder(const expression& x) : _expression(x) {
+        /*
+            A rotation the expression has not finished is carried
+            on by the builder, a cell or two at each change, so the
+            expression it freezes is as far through it as if built
+            by the expression's own operations.
+        */
+    }
+
+    std::size_t expression::builder::size() const {
+        return _size_(_expression);
+    }
+
+    void expression::builder::join(var x) {
+
+        if (x.is_nothing()) {
+            return;
+        }
+
+        _expression._lead = stream::cons(std::move(x), std::move(_expression._lead));
+        _expression._lead_size += 1;
+
+        _expression.schedule(1);
+        balance();
+    }
+
+    void expression::builder::link(var x) {
+
+        if (x.is_nothing()) {
+            return;
+        }
+
+        _expression._last = stream::cons(std::move(x), std::move(_expression._last));
+        _expression._last_size += 1;
+
+        _expression.schedule(1);
+        balance();
+    }
+
+    void expression::builder::next() {
+
+        if (!_expression._lead_size) {
+
+            _expression._last          = var();
+            _expression._last_schedule = var();
+            _expression._last_size     = 0;
+
+            return;
+        }
+
+        _expression._lead = stream::advance(_expression._lead);
+        _expression._lead_size -= 1;
+
+        _expression.schedule(2);
+        balance();
+    }
+
+    void expression::builder::prev() {
+
+        if (!_expression._last_size) {
+
+            _expression._lead          = var();
+            _expression._lead_schedule = var();
+            _expression._lead_size     = 0;
+
+            return;
+        }
+
+        _expression._last = stream::advance(_expression._last);
+        _expression._last_size -= 1;
+
+        _expression.schedule(2);
+        balance();
+    }
+
+    template <typename R>
+    void expression::builder::append_range(R&& range) {
+
+        for (auto&& x : range) {
+            link(var(x));
+        }
+    }
+
+    template <typename R>
+    void expression::builder::prepend_range(R&& range) {
+        /*
+            The elements are joined last first, so they are
+            gathered before.
+        */
+
+        std::vector<var> elements;
+
+        for (auto&& x : range) {
+            elements.emplace_back(x);
+        }
+
+        for (auto i = elements.rbegin(); i != elements.rend(); ++i) {
+            join(std::move(*i));
+        }
+    }
+
+    var expression::builder::freeze() {
+        /*
+            Both streams are balanced.  The builder's own rotations
+            are carried out at once, so the only one scheduled is
+            one begun by the expression it started from, if that is
+            not yet finished.
+        */
+
+        expression a;
+
+        a._lead          = std::move(_expression._lead);
+        a._last          = std::move(_expression._last);
+        a._lead_schedule = std::move(_expression._lead_schedule);
+        a._last_schedule = std::move(_expression._last_schedule);
+        a._lead_size     = std::exchange(_expression._lead_size, 0);
+        a._last_size     = std::exchange(_expression._last_size, 0);
+
+        return a;
+    }
+
+    void expression::builder::rotate(var& from, std::size_t keep, var& onto) {
+        /*
+            The cells kept by 'from' are cut from the rest, which
+            are the far end of the elements it holds.  They belong
+            at the far end of 'onto', in the opposite order.
+
+                onto' = onto ++ reverse(drop(keep, from))
+        */
+
+        var rest = stream::split(from, keep);
+
+        onto = stream::reverse_in_place(stream::reverse_in_place(std::move(onto), var()),
+                                        stream::reverse_in_place(std::move(rest), var()));
+    }
+
+    void expression::builder::balance() {
+
+        auto& e = _expression;
+
+        const std::size_t size = e._lead_size + e._last_size;
+
+        if (e._lead_size > balance_limit * e._last_size + 1) {
+
+            rotate(e._lead, size / 2, e._last);
+
+            e._lead_size = size / 2;
+            e._last_size = size - size / 2;
+        }
+
+        else if (e._last_size > balance_limit * e._lead_size + 1) {
+
+            rotate(e._last, size / 2, e._lead);
+
+            e._last_size = size / 2;
+            e._lead_size = size - size / 2;
+        }
+
+        else {
+            return;
+        }
+
+        /*
+            Both streams are now forced, so any rotation carried
+            over is finished.
+        */
+
+        e._lead_schedule = var();
+        e._last_schedule = var();
+    }
+
+    void expression::schedule(std::size_t cells) {
+
+        while (cells-- && (_lead_schedule.is_something() || _last_schedule.is_something())) {
+
+            _lead_schedule = stream::advance(_lead_schedule);
+            _last_schedule = stream::advance(_last_schedule);
+        }
+    }
+
+    void expression::balance() {
+        /*
+            Rotate half the elements of the longer stream onto
+            the end of the shorter, and schedule both.
+
+                lead' = take(i, lead)
+                last' = last ++ reverse(drop(i, lead))
+        */
+
+        const std::size_t size = _lead_size + _last_size;
+
+        if (_lead_size > balance_limit * _last_size + 1) {
+
+            const std::size_t i = size / 2;
+
+            _last = stream::rotate_drop(std::move(_last), i, _lead);
+            _lead = stream::take(i, std::move(_lead));
+
+            _lead_size = i;
+            _last_size = size - i;
+        }
+
+        else if (_last_size > balance_limit * _lead_size + 1) {
+
+            const std::size_t i = size / 2;
+
+            _lead = stream::rotate_drop(std::move(_lead), i, _last);
+            _last = stream::take(i, std::move(_last));
+
+            _last_size = i;
+            _lead_size = size - i;
+        }
+
+        else {
+            return;
+        }
+
+        _lead_schedule = _lead;
+        _last_schedule = _last;
     }
 }
\ No newline at end of file
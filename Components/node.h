@@ -33,6 +33,7 @@
 /*************************************************************************************/
 
 #include "../var.h"
+#include "sys/reclaimer.h"
 
 namespace Olly {
 
@@ -43,6 +44,19 @@ namespace Olly {
     //          The node class is implemented using Lisp inspired data nodes.  It
     //          is used to define the data sets as in Lisp.  
     //
+    //          Defining OLLY_CACHED_HASH caches the hash of the list beginning with
+    //          each node, computed once when the node is joined.  As the list is
+    //          immutable, hashing it is then constant time, and lists with differing
+    //          hashes compare unequal without being walked.
+    //
+    //          The '_op_' functions taking a mutable node are called by the rvalue
+    //          operations of 'var', when only that 'var' references the node, and
+    //          change it in place rather than copying it.
+    //
+    //          A node releases the cells following it in a loop, rather than through
+    //          the destructor of each, so lists of any length are released without
+    //          exhausting the stack.  See 'reclaimer.h' to bound the cells released.
+    //
     /********************************************************************************************/
 
     class node {
@@ -50,14 +64,33 @@ namespace Olly {
         var _data;
         var _next;
 
+#if defined(OLLY_CACHED_HASH)
+        std::uint64_t _hash;    // The hash of the list beginning with the node.
+        std::uint64_t _power;   // 'hash_multiplier' raised to the length of the list.
+
+        void cache_hash();                  // Cache the hash of the node alone.
+        void cache_hash(const node& next);  // Extend the cached hash with the list following the node.
+#endif
+
     public:
 
         node();
         node(var obj);
+        node(var obj, var next);  // A node joined onto the list 'next'.
+        node(const node& other) = default;
+        node(node&& other) noexcept = default;
+        ~node();
+
+        node& operator=(const node& other) = default;
+        node& operator=(node&& other) noexcept = default;
+
+        template <typename F> void           each(F&& f)   const;  // Call 'f' with each element, in order.
+        template <typename F> void  each_reversed(F&& f)   const;  // Call 'f' with each element, last first.
 
         friend Text          _type_(const node& self);
         friend bool            _is_(const node& self);
         friend double        _comp_(const node& self, const var& other);
+        friend bool        _equals_(const node& self, const var& other);
 
         friend void            _str_(Text_Stream& out, const node& self);
         friend void           _repr_(Text_Stream& out, const node& self);
@@ -65,8 +98,12 @@ namespace Olly {
         friend std::size_t    _size_(const node& self);
         friend var            _lead_(const node& self);
         friend var            _join_(const node& self, const var& other);
+        friend var            _join_(const node& self, var&& other);
+        friend void           _join_(node& self, var&& other);
         friend var            _next_(const node& self);
+        friend void           _next_(node& self);
         friend var         _reverse_(const node& self);
+        friend std::size_t    _hash_(const node& self);
     };
 
     /********************************************************************************************/
@@ -76,9 +113,185 @@ namespace Olly {
     /********************************************************************************************/
 
     node::node() : _data(), _next() {
+#if defined(OLLY_CACHED_HASH)
+        cache_hash();
+#endif
+    }
+
+    node::node(var object) : _data(std::move(object)), _next() {
+#if defined(OLLY_CACHED_HASH)
+        cache_hash();
+#endif
+    }
+
+    node::node(var object, var next) : _data(std::move(object)), _next() {
+#if defined(OLLY_CACHED_HASH)
+        cache_hash();
+#endif
+
+        auto cells = next.cast<node>();
+
+        if (cells && _is_(*cells)) {
+
+#if defined(OLLY_CACHED_HASH)
+            cache_hash(*cells);
+#endif
+            _next = std::move(next);
+        }
+    }
+
+    node::~node() {
+        /*
+            Unlink each cell only this node references, so that
+            releasing it finds no cell following it.  Once the
+            reclaimer's step is reached the rest is deferred.
+        */
+
+        if (!_next.is<node>() || !_next.unique()) {
+            return;
+        }
+
+        const std::size_t limit = reclaimer::step();
+
+        std::size_t cells = 0;
+
+        var next = std::move(_next);
+
+        while (next.unique()) {
+
+            auto cell = next.cast<node>();
+
+            if (!cell) {
+                break;
+            }
+
+            if (cells == limit) {
+
+                reclaimer::defer(std::move(next));
+
+                break;
+            }
+
+            var after = std::move(const_cast<node*>(cell.get())->_next);
+
+            next = std::move(after);
+
+            cells += 1;
+        }
+
+        reclaimer::released(cells);
+    }
+
+#if defined(OLLY_CACHED_HASH)
+    void node::cache_hash() {
+
+        if (_is_(*this)) {
+
+            _hash  = hash_combine(hash_seed, _data.hash());
+            _power = hash_multiplier;
+        }
+        else {
+
+            _hash  = hash_seed;
+            _power = 1;
+        }
+    }
+
+    void node::cache_hash(const node& next) {
+        /*
+            The hash of a list is a polynomial in 'hash_multiplier',
+            so the hash of the node followed by a list only needs
+            the hash and the power of each.
+
+                H(x : next) = H(next) + (H(x) - seed) * B^|next|
+        */
+
+        _hash  = next._hash + (_hash - hash_seed) * next._power;
+        _power = _power * next._power;
     }
+#endif
+
+    template <typename F>
+    void node::each(F&& f) const {
+
+        const node* a = this;
+
+        while (a && _is_(*a)) {
+
+            f(a->_data);
+
+            a = a->_next.cast<node>().get();
+        }
+    }
+
+    template <typename F>
+    void node::each_reversed(F&& f) const {
+        /*
+            Visit the list backwards without building a reversed
+            copy of it.  The cells are split into blocks of about
+            the square root of the length, and the first cell of
+            each block is marked.  Each block is then walked from
+            its mark, and its cells are visited in reverse.  So
+            every cell is walked twice, and only the marks and
+            one block of borrowed pointers are held at a time.
+        */
+
+        static constexpr std::size_t local_cells = 64;
+
+        std::size_t length = 0;
+
+        for (const node* a = this; a && _is_(*a); a = a->_next.cast<node>().get()) {
+            ++length;
+        }
+
+        if (length <= local_cells) {
 
-    node::node(var object) : _data(object), _next() {
+            const node* cells[local_cells];
+
+            std::size_t i = 0;
+
+            for (const node* a = this; i < length; a = a->_next.cast<node>().get()) {
+                cells[i++] = a;
+            }
+
+            while (i) {
+                f(cells[--i]->_data);
+            }
+
+            return;
+        }
+
+        const std::size_t block = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(length))));
+
+        std::vector<const node*> marks;
+        std::vector<const node*> cells;
+
+        marks.reserve(length / block + 1);
+        cells.reserve(block);
+
+        std::size_t i = 0;
+
+        for (const node* a = this; i < length; a = a->_next.cast<node>().get(), ++i) {
+
+            if (i % block == 0) {
+                marks.push_back(a);
+            }
+        }
+
+        for (auto mark = marks.rbegin(); mark != marks.rend(); ++mark) {
+
+            cells.clear();
+
+            const node* a = *mark;
+
+            for (std::size_t j = 0; j < block && a && _is_(*a); ++j, a = a->_next.cast<node>().get()) {
+                cells.push_back(a);
+            }
+
+            for (auto cell = cells.rbegin(); cell != cells.rend(); ++cell) {
+                f((*cell)->_data);
+            }
+        }
     }
 
     std::string _type_(const node& self) {
@@ -95,20 +308,33 @@ namespace Olly {
 
         if (ptr) {
 
-            var a = self;
-            var b = *ptr;
+#if defined(OLLY_CACHED_HASH)
+            if (self._hash != ptr->_hash) {
+                return NOT_A_NUMBER;
+            }
+#endif
+            /*
+                Walk the cells in place, rather than copying them into 'var's.
+            */
+
+            const node* a = &self;
+            const node* b = ptr.get();
 
-            while (a.is() && b.is()) {
+            while (a && b && _is_(*a) && _is_(*b)) {
 
-                if (a.lead() != b.lead()) {
+                if (a == b) {
+                    return 0.0;  // The remaining cells are shared.
+                }
+
+                if (!a->_data.equals(b->_data)) {
                     return NOT_A_NUMBER;
                 }
 
-                a = a.next();
-                b = b.next();
+                a = a->_next.cast<node>().get();
+                b = b->_next.cast<node>().get();
             }
 
-            if (!a.is() && !b.is()) {
+            if ((!a || !_is_(*a)) && (!b || !_is_(*b))) {
                 return 0.0;
             }
         }
@@ -116,20 +342,54 @@ namespace Olly {
         return NOT_A_NUMBER;
     }
 
+    bool _equals_(const node& self, const var& other) {
+        return _comp_(self, other) == 0.0;
+    }
+
+    std::size_t _hash_(const node& self) {
+        /*
+            Fold the hash of each element in order, so equal
+            lists hash equally.
+        */
+
+#if defined(OLLY_CACHED_HASH)
+        return self._hash;
+#else
+        std::uint64_t h = hash_seed;
+
+        const node* a = &self;
+
+        while (a && _is_(*a)) {
+
+            h = hash_combine(h, a->_data.hash());
+            a = a->_next.cast<node>().get();
+        }
+
+        return h;
+#endif
+    }
+
     void _str_(Text_Stream& out, const node& self) {
 
         if (!_is_(self)) {
             return;
         }
 
-        var e(self);
+        /*
+            Separate the elements, rather than following
+            each with a space that must then be erased.
+        */
 
-        while (e.is()) {
-            e.lead().str(out);
+        self._data.str(out);
 
-            e = e.next();
+        const node* a = self._next.cast<node>().get();
 
-            out << " ";
+        while (a && _is_(*a)) {
+
+            out.put(' ');
+
+            a->_data.str(out);
+            a = a->_next.cast<node>().get();
         }
     }
 
@@ -139,14 +399,21 @@ namespace Olly {
             return;
         }
 
-        var e(self);
+        /*
+            Separate the elements, rather than following
+            each with a space that must then be erased.
+        */
+
+        self._data.repr(out);
+
+        const node* a = self._next.cast<node>().get();
 
-        while (e.is()) {
-            e.lead().repr(out);
+        while (a && _is_(*a)) {
 
-            e = e.next();
+            out.put(' ');
 
-            out << " ";
+            a->_data.repr(out);
+            a = a->_next.cast<node>().get();
         }
     }
 
@@ -175,21 +442,47 @@ namespace Olly {
     }
 
     var _join_(const node& self, const var& other) {
+        return _join_(self, var(other));
+    }
+
+    var _join_(const node& self, var&& other) {
 
         if (other.is_nothing()) {
             return self;
         }
 
-        node a(other);
+        node a(std::move(other));
 
         if (_is_(self)) {
 
             a._next = self;
+
+#if defined(OLLY_CACHED_HASH)
+            a.cache_hash(self);
+#endif
         }
 
         return a;
     }
 
+    void _join_(node& self, var&& other) {
+        /*
+            The node is moved into a cell of its own, following
+            the new element, rather than copied.
+        */
+
+        if (other.is_nothing()) {
+            return;
+        }
+
+        if (!_is_(self)) {
+            self = node(std::move(other));
+            return;
+        }
+
+        self = node(std::move(other), std::move(self));
+    }
+
     var _next_(const node& self) {
 
         if (self._next.is_nothing()) {
@@ -199,6 +492,13 @@ namespace Olly {
         return self._next;
     }
 
+    void _next_(node& self) {
+
+        auto next = self._next.cast<node>();
+
+        self = next ? node(*next) : node();
+    }
+
     var _reverse_(const node& self) {
 
         if (self._next.is_nothing()) {
@@ -0,0 +1,985 @@
+#pragma once
+
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include "../var.h"
+
+namespace Olly {
+
+    /********************************************************************************************/
+    //
+    //                               'sequence' Class Definition
+    //
+    //          The sequence class is a 2-3 finger tree, after Hinze and Paterson, whose
+    //          nodes are annotated with the number of elements they hold.  It supports
+    //          the same operations as 'expression', and may stand in for one wherever
+    //          only the 'var' API is used.
+    //
+    //          Joining, linking and removing an element at either end takes constant
+    //          time on average.  Concatenating two sequences, and taking, dropping or
+    //          splitting at an index, take time in proportion to the logarithm of the
+    //          size, where 'expression' takes time in proportion to the elements moved.
+    //          Reversing a sequence copies it.
+    //
+    /********************************************************************************************/
+
+    class sequence {
+
+        struct branch {                 // A node of two or three items of the level above.
+            var          _items[3];
+            std::size_t  _count;
+            std::size_t  _size;         // The elements held beneath the node.
+        };
+
+        struct tree {                   // A finger tree of elements, or of branches below the top.
+            std::size_t  _size;         // The elements held beneath the tree.
+            var          _prefix[4];
+            var          _suffix[4];
+            var          _middle;       // A tree of branches, or nothing.
+            std::size_t  _prefix_count;
+            std::size_t  _suffix_count; // Zero for a tree holding a single item.
+        };
+
+        class cursor;                   // Walks the items of a tree in order, without allocating.
+
+        var _tree;  // Nothing when the sequence is empty.
+
+        static std::size_t measure(const var& item);
+        static std::size_t measure(const var* items, std::size_t count);
+        static std::size_t    size(const var& t);
+
+        static var      single(var item);
+        static var        deep(const var* prefix, std::size_t np, var middle, const var* suffix, std::size_t ns);
+        static var        make(const var* prefix, std::size_t np, const var& middle, const var* suffix, std::size_t ns);
+        static var  from_items(const var* items, std::size_t count);
+        static var   branch_of(const var* items, std::size_t count);
+
+        static const var&    front(const var& t);
+        static const var&     back(const var& t);
+        static var      push_front(const var& t, var item);
+        static var       push_back(const var& t, var item);
+        static var       pop_front(const var& t);
+        static var        pop_back(const var& t);
+
+        static var          concat(const var& a, const var* items, std::size_t count, const var& b);
+        static void          split(const var& t, std::size_t& index, var& left, var& item, var& right);
+        static std::size_t  locate(const var* items, std::size_t count, std::size_t& index);
+
+        template <typename F> static void           each(const var& t, F& f);
+        template <typename F> static void  each_reversed(const var& t, F& f);
+        template <typename F> static void          visit(const var& item, F& f);
+        template <typename F> static void  visit_reversed(const var& item, F& f);
+
+        explicit sequence(var t, std::nullptr_t);
+
+    public:
+
+        sequence();
+        sequence(var x);
+        template<typename T, typename... Args>
+        sequence(T x, Args... args);
+
+        template <typename F> void           each(F&& f)   const;  // Call 'f' with each element, in order.
+        template <typename F> void  each_reversed(F&& f)   const;  // Call 'f' with each element, last first.
+
+        std::pair<var, var> split(std::size_t n) const;  // The first 'n' elements, and the rest.
+
+        friend Text           _type_(const sequence& self);
+        friend bool             _is_(const sequence& self);
+        friend double         _comp_(const sequence& self, const var& other);
+        friend bool         _equals_(const sequence& self, const var& other);
+
+        friend void            _str_(Text_Stream& out, const sequence& self);
+        friend void           _repr_(Text_Stream& out, const sequence& self);
+
+        friend std::size_t    _size_(const sequence& self);
+        friend var            _lead_(const sequence& self);
+        friend var            _last_(const sequence& self);
+        friend var            _join_(const sequence& self, const var& other);
+        friend var            _join_(const sequence& self, var&& other);
+        friend var            _link_(const sequence& self, const var& other);
+        friend var            _link_(const sequence& self, var&& other);
+        friend var            _next_(const sequence& self);
+        friend var            _prev_(const sequence& self);
+        friend var            _drop_(const sequence& self, std::size_t n);
+        friend var            _take_(const sequence& self, std::size_t n);
+        friend var         _reverse_(const sequence& self);
+        friend std::size_t    _hash_(const sequence& self);
+
+        friend var             _add_(const sequence& self, const var& other);
+
+        template<typename... Args>
+        void link(const var& other, Args... args);
+        void link(const var& other);
+        void link(var&& other);
+        void link();
+    };
+
+    /********************************************************************************************/
+    //
+    //                                 'sequence' Class Implementation
+    //
+    /********************************************************************************************/
+
+    sequence::sequence() : _tree() {
+    }
+
+    sequence::sequence(var x) : _tree() {
+
+        link(std::move(x));
+    }
+
+    template<typename T, typename... Args>
+    sequence::sequence(T x, Args... args) : _tree() {
+
+        link(x);
+        link(args...);
+    }
+
+    sequence::sequence(var t, std::nullptr_t) : _tree(std::move(t)) {
+    }
+
+    std::size_t sequence::measure(const var& item) {
+        /*
+            Elements are never branches, so an item
+            is only measured as a branch below the top.
+        */
+
+        auto b = item.cast<branch>();
+
+        return b ? b->_size : 1;
+    }
+
+    std::size_t sequence::measure(const var* items, std::size_t count) {
+
+        std::size_t n = 0;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            n += measure(items[i]);
+        }
+
+        return n;
+    }
+
+    std::size_t sequence::size(const var& t) {
+
+        auto x = t.cast<tree>();
+
+        return x ? x->_size : 0;
+    }
+
+    var sequence::single(var item) {
+
+        tree x;
+
+        x._size         = measure(item);
+        x._prefix[0]    = std::move(item);
+        x._prefix_count = 1;
+        x._suffix_count = 0;
+
+        return x;
+    }
+
+    var sequence::deep(const var* prefix, std::size_t np, var middle, const var* suffix, std::size_t ns) {
+
+        tree x;
+
+        x._size         = measure(prefix, np) + size(middle) + measure(suffix, ns);
+        x._middle       = std::move(middle);
+        x._prefix_count = np;
+        x._suffix_count = ns;
+
+        std::copy(prefix, prefix + np, x._prefix);
+        std::copy(suffix, suffix + ns, x._suffix);
+
+        return x;
+    }
+
+    var sequence::make(const var* prefix, std::size_t np, const var& middle, const var* suffix, std::size_t ns) {
+        /*
+            Either digit may be empty, in which case it is
+            refilled from the branch at that end of the middle.
+        */
+
+        if (!np) {
+
+            if (middle.is_nothing()) {
+                return from_items(suffix, ns);
+            }
+
+            auto b = front(middle).cast<branch>();
+
+            return make(b->_items, b->_count, pop_front(middle), suffix, ns);
+        }
+
+        if (!ns) {
+
+            if (middle.is_nothing()) {
+                return from_items(prefix, np);
+            }
+
+            auto b = back(middle).cast<branch>();
+
+            return make(prefix, np, pop_back(middle), b->_items, b->_count);
+        }
+
+        return deep(prefix, np, middle, suffix, ns);
+    }
+
+    var sequence::from_items(const var* items, std::size_t count) {
+
+        if (!count) {
+            return var();
+        }
+
+        if (count == 1) {
+            return single(items[0]);
+        }
+
+        const std::size_t np = count / 2;
+
+        return deep(items, np, var(), items + np, count - np);
+    }
+
+    var sequence::branch_of(const var* items, std::size_t count) {
+
+        branch b;
+
+        b._count = count;
+        b._size  = measure(items, count);
+
+        std::copy(items, items + count, b._items);
+
+        return b;
+    }
+
+    const var& sequence::front(const var& t) {
+        return t.cast<tree>()->_prefix[0];
+    }
+
+    const var& sequence::back(const var& t) {
+
+        auto x = t.cast<tree>();
+
+        return x->_suffix_count ? x->_suffix[x->_suffix_count - 1] : x->_prefix[0];
+    }
+
+    var sequence::push_front(const var& t, var item) {
+
+        auto x = t.cast<tree>();
+
+        if (!x) {
+            return single(std::move(item));
+        }
+
+        if (!x->_suffix_count) {
+            return deep(&item, 1, var(), x->_prefix, 1);
+        }
+
+        if (x->_prefix_count == 4) {
+            /*
+                A full digit keeps one item, and pushes the
+                other three down as a branch.
+            */
+
+            const var prefix[2] = { std::move(item), x->_prefix[0] };
+
+            return deep(prefix, 2, push_front(x->_middle, branch_of(x->_prefix + 1, 3)), x->_suffix, x->_suffix_count);
+        }
+
+        var prefix[4];
+
+        prefix[0] = std::move(item);
+
+        std::copy(x->_prefix, x->_prefix + x->_prefix_count, prefix + 1);
+
+        return deep(prefix, x->_prefix_count + 1, x->_middle, x->_suffix, x->_suffix_count);
+    }
+
+    var sequence::push_back(const var& t, var item) {
+
+        auto x = t.cast<tree>();
+
+        if (!x) {
+            return single(std::move(item));
+        }
+
+        if (!x->_suffix_count) {
+            return deep(x->_prefix, 1, var(), &item, 1);
+        }
+
+        if (x->_suffix_count == 4) {
+
+            const var suffix[2] = { x->_suffix[3], std::move(item) };
+
+            return deep(x->_prefix, x->_prefix_count, push_back(x->_middle, branch_of(x->_suffix, 3)), suffix, 2);
+        }
+
+        var suffix[4];
+
+        std::copy(x->_suffix, x->_suffix + x->_suffix_count, suffix);
+
+        suffix[x->_suffix_count] = std::move(item);
+
+        return deep(x->_prefix, x->_prefix_count, x->_middle, suffix, x->_suffix_count + 1);
+    }
+
+    var sequence::pop_front(const var& t) {
+
+        auto x = t.cast<tree>();
+
+        if (!x->_suffix_count) {
+            return var();
+        }
+
+        return make(x->_prefix + 1, x->_prefix_count - 1, x->_middle, x->_suffix, x->_suffix_count);
+    }
+
+    var sequence::pop_back(const var& t) {
+
+        auto x = t.cast<tree>();
+
+        if (!x->_suffix_count) {
+            return var();
+        }
+
+        return make(x->_prefix, x->_prefix_count, x->_middle, x->_suffix, x->_suffix_count - 1);
+    }
+
+    var sequence::concat(const var& a, const var* items, std::size_t count, const var& b) {
+        /*
+            Join two trees with the items between them.  The
+            inner digits and the items are packed into branches
+            and joined one level down, so only the spine of the
+            trees is copied.
+        */
+
+        auto x = a.cast<tree>();
+        auto y = b.cast<tree>();
+
+        if (!x) {
+
+            var t = b;
+
+            for (std::size_t i = count; i--; ) {
+                t = push_front(t, items[i]);
+            }
+
+            return t;
+        }
+
+        if (!y) {
+
+            var t = a;
+
+            for (std::size_t i = 0; i < count; ++i) {
+                t = push_back(t, items[i]);
+            }
+
+            return t;
+        }
+
+        if (!x->_suffix_count) {
+            return push_front(concat(var(), items, count, b), x->_prefix[0]);
+        }
+
+        if (!y->_suffix_count) {
+            return push_back(concat(a, items, count, var()), y->_prefix[0]);
+        }
+
+        var inner[12];
+
+        std::size_t n = 0;
+
+        for (std::size_t i = 0; i < x->_suffix_count; ++i) {
+            inner[n++] = x->_suffix[i];
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            inner[n++] = items[i];
+        }
+
+        for (std::size_t i = 0; i < y->_prefix_count; ++i) {
+            inner[n++] = y->_prefix[i];
+        }
+
+        var branches[4];
+
+        std::size_t m = 0;
+        std::size_t i = 0;
+
+        while (n - i > 4) {
+
+            branches[m++] = branch_of(inner + i, 3);
+            i += 3;
+        }
+
+        if (n - i == 4) {
+
+            branches[m++] = branch_of(inner + i, 2);
+            branches[m++] = branch_of(inner + i + 2, 2);
+        }
+        else {
+            branches[m++] = branch_of(inner + i, n - i);
+        }
+
+        return deep(x->_prefix, x->_prefix_count, concat(x->_middle, branches, m, y->_middle), y->_suffix, y->_suffix_count);
+    }
+
+    std::size_t sequence::locate(const var* items, std::size_t count, std::size_t& index) {
+
+        std::size_t i = 0;
+
+        while (i + 1 < count && index >= measure(items[i])) {
+
+            index -= measure(items[i]);
+            i += 1;
+        }
+
+        return i;
+    }
+
+    void sequence::split(const var& t, std::size_t& index, var& left, var& item, var& right) {
+        /*
+            Find the item holding the element at 'index', and
+            the trees either side of it.  The index is left
+            relative to the item found.
+        */
+
+        auto x = t.cast<tree>();
+
+        if (!x->_suffix_count) {
+
+            item = x->_prefix[0];
+
+            return;
+        }
+
+        const std::size_t prefix = measure(x->_prefix, x->_prefix_count);
+        const std::size_t middle = size(x->_middle);
+
+        if (index < prefix) {
+
+            std::size_t i = locate(x->_prefix, x->_prefix_count, index);
+
+            left  = from_items(x->_prefix, i);
+            item  = x->_prefix[i];
+            right = make(x->_prefix + i + 1, x->_prefix_count - i - 1, x->_middle, x->_suffix, x->_suffix_count);
+        }
+
+        else if (index < prefix + middle) {
+
+            index -= prefix;
+
+            var ml;
+            var mx;
+            var mr;
+
+            split(x->_middle, index, ml, mx, mr);
+
+            auto b = mx.cast<branch>();
+
+            std::size_t i = locate(b->_items, b->_count, index);
+
+            left  = make(x->_prefix, x->_prefix_count, ml, b->_items, i);
+            item  = b->_items[i];
+            right = make(b->_items + i + 1, b->_count - i - 1, mr, x->_suffix, x->_suffix_count);
+        }
+
+        else {
+
+            index -= prefix + middle;
+
+            std::size_t i = locate(x->_suffix, x->_suffix_count, index);
+
+            left  = make(x->_prefix, x->_prefix_count, x->_middle, x->_suffix, i);
+            item  = x->_suffix[i];
+            right = from_items(x->_suffix + i + 1, x->_suffix_count - i - 1);
+        }
+    }
+
+    template <typename F>
+    void sequence::each(const var& t, F& f) {
+
+        auto x = t.cast<tree>();
+
+        if (!x) {
+            return;
+        }
+
+        for (std::size_t i = 0; i < x->_prefix_count; ++i) {
+            visit(x->_prefix[i], f);
+        }
+
+        each(x->_middle, f);
+
+        for (std::size_t i = 0; i < x->_suffix_count; ++i) {
+            visit(x->_suffix[i], f);
+        }
+    }
+
+    template <typename F>
+    void sequence::each_reversed(const var& t, F& f) {
+
+        auto x = t.cast<tree>();
+
+        if (!x) {
+            return;
+        }
+
+        for (std::size_t i = x->_suffix_count; i--; ) {
+            visit_reversed(x->_suffix[i], f);
+        }
+
+        each_reversed(x->_middle, f);
+
+        for (std::size_t i = x->_prefix_count; i--; ) {
+            visit_reversed(x->_prefix[i], f);
+        }
+    }
+
+    template <typename F>
+    void sequence::visit(const var& item, F& f) {
+
+        auto b = item.cast<branch>();
+
+        if (!b) {
+
+            f(item);
+
+            return;
+        }
+
+        for (std::size_t i = 0; i < b->_count; ++i) {
+            visit(b->_items[i], f);
+        }
+    }
+
+    template <typename F>
+    void sequence::visit_reversed(const var& item, F& f) {
+
+        auto b = item.cast<branch>();
+
+        if (!b) {
+
+            f(item);
+
+            return;
+        }
+
+        for (std::size_t i = b->_count; i--; ) {
+            visit_reversed(b->_items[i], f);
+        }
+    }
+
+    class sequence::cursor {
+
+        /********************************************************************************************/
+        //
+        //      Holds the items still to be walked as a stack of ranges, the first range on
+        //      top.  A tree is opened into its prefix, middle and suffix, and a branch into
+        //      its items, only when asked to, so the items two sequences share are skipped
+        //      whole.  Each level of a tree adds at most three ranges, and each branch one,
+        //      so a fixed stack suffices for any size that can be held.
+        //
+        /********************************************************************************************/
+
+        struct range {
+            const var* first;
+            const var* last;
+        };
+
+        static constexpr std::size_t depth = 256;
+
+        range       _ranges[depth];
+        std::size_t _count;
+
+        void push(const var* first, std::size_t n);
+
+    public:
+
+        explicit cursor(const var& t);
+
+        const var*  front() const;  // The next item, an element, a branch or a tree, or null once done.
+        void        pop();          // Skip the next item.
+        void        open();         // Replace the next item, a branch or a tree, with the items it holds.
+    };
+
+    sequence::cursor::cursor(const var& t) : _ranges(), _count(0) {
+        push(&t, t.is_something() ? 1 : 0);
+    }
+
+    void sequence::cursor::push(const var* first, std::size_t n) {
+
+        if (!n) {
+            return;
+        }
+
+        assert(_count < depth && "A sequence cursor must fit its stack.");
+
+        _ranges[_count++] = { first, first + n };
+    }
+
+    const var* sequence::cursor::front() const {
+        return _count ? _ranges[_count - 1].first : nullptr;
+    }
+
+    void sequence::cursor::pop() {
+
+        range& r = _ranges[_count - 1];
+
+        if (++r.first == r.last) {
+            --_count;
+        }
+    }
+
+    void sequence::cursor::open() {
+
+        const var& item = *front();
+
+        pop();
+
+        if (auto b = item.cast<branch>()) {
+
+            push(b->_items, b->_count);
+
+            return;
+        }
+
+        if (auto x = item.cast<tree>()) {
+
+            push(x->_suffix, x->_suffix_count);
+
+            if (x->_middle.is_something()) {
+                push(&x->_middle, 1);
+            }
+
+            push(x->_prefix, x->_prefix_count);
+        }
+    }
+
+    template <typename F>
+    void sequence::each(F&& f) const {
+        each(_tree, f);
+    }
+
+    template <typename F>
+    void sequence::each_reversed(F&& f) const {
+        each_reversed(_tree, f);
+    }
+
+    std::pair<var, var> sequence::split(std::size_t n) const {
+
+        if (!n) {
+            return { sequence(), *this };
+        }
+
+        if (n >= size(_tree)) {
+            return { *this, sequence() };
+        }
+
+        var left;
+        var item;
+        var right;
+
+        split(_tree, n, left, item, right);
+
+        return { sequence(std::move(left), nullptr), sequence(push_front(right, std::move(item)), nullptr) };
+    }
+
+    std::string _type_(const sequence& self) {
+        return "sequence";
+    }
+
+    bool _is_(const sequence& self) {
+        return self._tree.is_something();
+    }
+
+    double _comp_(const sequence& self, const var& other) {
+        return _equals_(self, other) ? 0.0 : NOT_A_NUMBER;
+    }
+
+    bool _equals_(const sequence& self, const var& other) {
+
+        auto ptr = other.cast<sequence>();
+
+        if (ptr) {
+
+            if (self._tree.cast<sequence::tree>().get() == ptr->_tree.cast<sequence::tree>().get()) {
+                return true;
+            }
+
+            if (_size_(self) != _size_(*ptr)) {
+                return false;
+            }
+
+            /*
+                Both trees are walked in lockstep, opening whichever
+                next item holds more elements until both are single
+                elements, which are compared.  The walk stops at the
+                first difference, and skips an item both share.
+            */
+
+            sequence::cursor a(self._tree);
+            sequence::cursor b(ptr->_tree);
+
+            while (a.front() && b.front()) {
+
+                const var& x = *a.front();
+                const var& y = *b.front();
+
+                auto x_branch = x.cast<sequence::branch>();
+                auto y_branch = y.cast<sequence::branch>();
+
+                if (x_branch || y_branch) {
+
+                    if (x_branch.get() == y_branch.get()) {
+                        a.pop();
+                        b.pop();
+                    }
+                    else if (x_branch && (!y_branch || x_branch->_size >= y_branch->_size)) {
+                        a.open();
+                    }
+                    else {
+                        b.open();
+                    }
+
+                    continue;
+                }
+
+                auto x_tree = x.cast<sequence::tree>();
+                auto y_tree = y.cast<sequence::tree>();
+
+                if (x_tree || y_tree) {
+
+                    if (x_tree.get() == y_tree.get()) {
+                        a.pop();
+                        b.pop();
+                    }
+                    else {
+
+                        if (x_tree) {
+                            a.open();
+                        }
+
+                        if (y_tree) {
+                            b.open();
+                        }
+                    }
+
+                    continue;
+                }
+
+                if (!x.equals(y)) {
+                    return false;
+                }
+
+                a.pop();
+                b.pop();
+            }
+
+            return !a.front() && !b.front();
+        }
+
+        return false;
+    }
+
+    void _str_(Text_Stream& out, const sequence& self) {
+
+        out << "(";
+
+        const char* separator = "";  // Written before every element but the first.
+
+        self.each([&](const var& x) {
+            out << separator;
+
+            x.str(out);
+
+            separator = " ";
+        });
+
+        out << ")";
+    }
+
+    void _repr_(Text_Stream& out, const sequence& self) {
+
+        out << "(";
+
+        const char* separator = "";  // Written before every element but the first.
+
+        self.each([&](const var& x) {
+            out << separator;
+
+            x.repr(out);
+
+            separator = " ";
+        });
+
+        out << ")";
+    }
+
+    std::size_t _size_(const sequence& self) {
+        return sequence::size(self._tree);
+    }
+
+    var _lead_(const sequence& self) {
+
+        if (self._tree.is_nothing()) {
+            return var();
+        }
+
+        return sequence::front(self._tree);
+    }
+
+    var _last_(const sequence& self) {
+
+        if (self._tree.is_nothing()) {
+            return var();
+        }
+
+        return sequence::back(self._tree);
+    }
+
+    var _join_(const sequence& self, const var& other) {
+        return _join_(self, var(other));
+    }
+
+    var _join_(const sequence& self, var&& other) {
+
+        if (other.is_nothing()) {
+            return self;
+        }
+
+        return sequence(sequence::push_front(self._tree, std::move(other)), nullptr);
+    }
+
+    var _link_(const sequence& self, const var& other) {
+        return _link_(self, var(other));
+    }
+
+    var _link_(const sequence& self, var&& other) {
+
+        if (other.is_nothing()) {
+            return self;
+        }
+
+        return sequence(sequence::push_back(self._tree, std::move(other)), nullptr);
+    }
+
+    var _next_(const sequence& self) {
+
+        if (self._tree.is_nothing()) {
+            return sequence();
+        }
+
+        return sequence(sequence::pop_front(self._tree), nullptr);
+    }
+
+    var _prev_(const sequence& self) {
+
+        if (self._tree.is_nothing()) {
+            return sequence();
+        }
+
+        return sequence(sequence::pop_back(self._tree), nullptr);
+    }
+
+    var _drop_(const sequence& self, std::size_t n) {
+        return self.split(n).second;
+    }
+
+    var _take_(const sequence& self, std::size_t n) {
+        return self.split(n).first;
+    }
+
+    var _reverse_(const sequence& self) {
+
+        var t;
+
+        self.each_reversed([&](const var& x) {
+            t = sequence::push_back(t, x);
+        });
+
+        return sequence(std::move(t), nullptr);
+    }
+
+    std::size_t _hash_(const sequence& self) {
+        /*
+            Fold the hash of each element in order, as
+            'expression' does, so equal sequences hash equally.
+        */
+
+        std::uint64_t h = hash_seed;
+
+        self.each([&](const var& x) {
+            h = hash_combine(h, x.hash());
+        });
+
+        return h;
+    }
+
+    var _add_(const sequence& self, const var& other) {
+
+        auto ptr = other.cast<sequence>();
+
+        if (ptr) {
+            return sequence(sequence::concat(self._tree, nullptr, 0, ptr->_tree), nullptr);
+        }
+
+        return nothing();
+    }
+
+    template<typename ...Args>
+    void sequence::link(const var& other, Args... args) {
+
+        link(other);
+
+        link(args...);
+    }
+
+    void sequence::link(const var& other) {
+        link(var(other));
+    }
+
+    void sequence::link(var&& other) {
+
+        if (other.is_nothing()) {
+            return;
+        }
+
+        _tree = push_back(_tree, std::move(other));
+    }
+
+    void sequence::link() {
+    }
+}
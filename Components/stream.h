@@ -0,0 +1,766 @@
+#pragma once
+
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include "../var.h"
+#include "sys/reclaimer.h"
+
+namespace Olly {
+
+    /********************************************************************************************/
+    //
+    //                               'stream' Class Definition
+    //
+    //          The stream class is a Lisp inspired lazy list.  Each cell is either
+    //          forced, holding an element and the stream following it, or suspended,
+    //          holding the operation and the arguments which compute it.  A cell is
+    //          forced once, the first time it is read, and every version sharing the
+    //          cell shares the result.  An empty stream is held as nothing.
+    //
+    //          The operations are those the real time deque of Okasaki is built on.
+    //          The incremental one, 'take', forces one cell of its argument per cell
+    //          forced.  The monolithic ones, 'drop' and 'reverse', are carried out at
+    //          once, and are only ever applied to a few cells.  The rotations move
+    //          'rotation_step' cells per cell forced.
+    //
+    //          Splitting and reversing in place relink the cells only the stream given
+    //          references, rather than copying them, as no other version can see them.
+    //          The cells any other version references are copied instead.
+    //
+    //          As with 'node', the cells only a stream references are released in a
+    //          loop, rather than through the destructor of each.
+    //
+    //          Defining OLLY_CACHED_HASH caches in each forced cell the hash of the
+    //          stream beginning with it, and of that stream reversed, the first time
+    //          it is hashed.  A cell relinked in place forgets them.
+    //
+    /********************************************************************************************/
+
+    class stream {
+
+        enum class operation : std::uint8_t { none, take, rotate_reverse, rotate_drop };
+
+        enum state : std::uint8_t { suspended, forcing, evaluated };
+
+        mutable std::atomic<std::uint8_t> _state;
+        mutable operation                 _operation;
+        mutable var                       _head;    // The element, or the first argument while suspended.
+        mutable var                       _tail;    // The stream following, or the second argument.
+        mutable var                       _rest;    // The third argument while suspended.
+        mutable std::size_t               _count;   // The count argument while suspended.
+
+#if defined(OLLY_CACHED_HASH)
+        mutable std::atomic<bool>          _hashed;   // Whether the hashes below are cached.
+        mutable std::atomic<std::uint64_t> _hash;     // The hash of the stream beginning with the cell.
+        mutable std::atomic<std::uint64_t> _reverse;  // The hash of that stream reversed.
+        mutable std::atomic<std::uint64_t> _power;    // 'hash_multiplier' raised to the length of that stream.
+#endif
+
+        stream(operation op, var a, var b, var c, std::size_t n);
+
+        void evaluate() const;                          // Force the cell in place.
+        const stream* forced() const;                   // The forced cell, or null if it is empty.
+
+        static void evaluate(operation op, const var& a, const var& b, const var& c, std::size_t n, var& head, var& tail);
+        static void evaluate(const var& s, var& head, var& tail);
+
+    public:
+
+        static constexpr std::size_t rotation_step = 3;  // The cells moved by a rotation per cell forced.
+
+        stream();
+        stream(var x, var next);
+        stream(const stream& other);
+        stream(stream&& other) noexcept;
+        ~stream();
+
+        static var           cons(var x, var s);                    // The stream of 'x' followed by 's'.
+        static var           take(std::size_t n, var s);            // The first 'n' cells of 's', lazily.
+        static var           drop(std::size_t n, var s);            // All but the first 'n' cells of 's'.
+        static var        reverse(var s, std::size_t n, var a);     // The first 'n' cells of 's' reversed, then 'a'.
+        static var rotate_reverse(var f, var r, var a);             // 'f' followed by 'r' reversed, then 'a', lazily.
+        static var    rotate_drop(var f, std::size_t n, var r);     // 'f' followed by all but 'n' cells of 'r' reversed, lazily.
+        static var          split(var& s, std::size_t n);           // Keep the first 'n' cells of 's', and return the rest.
+        static var reverse_in_place(var s, var a);                  // 's' reversed, then 'a'.
+
+        static const stream* force(const var& s);                   // The first cell of 's' forced, or null if it is empty.
+        static var         advance(const var& s);                   // Force the first cell of 's' and return the stream following it.
+
+#if defined(OLLY_CACHED_HASH)
+        struct hashes {
+            std::uint64_t hash;     // The hash of the stream.
+            std::uint64_t reverse;  // The hash of the stream reversed.
+            std::uint64_t power;    // 'hash_multiplier' raised to the length of the stream.
+        };
+
+        static hashes         hash(const var& s);                   // The hashes of 's', cached in each cell.
+        static bool         hashed(const var& s);                   // Whether the hashes of 's' are cached.
+#endif
+
+        const var& head() const;  // The element of a forced cell.
+        const var& tail() const;  // The stream following a forced cell.
+
+        template <typename F> void           each(F&& f)   const;  // Call 'f' with each element, in order.
+        template <typename F> void  each_reversed(F&& f)   const;  // Call 'f' with each element, last first.
+        template <typename F> bool   all_reversed(std::size_t n, F&& f) const;  // Call 'f' with the first 'n' elements, last first, until it returns false.
+
+        friend Text           _type_(const stream& self);
+        friend bool             _is_(const stream& self);
+
+        friend void            _str_(Text_Stream& out, const stream& self);
+        friend void           _repr_(Text_Stream& out, const stream& self);
+
+        friend std::size_t    _size_(const stream& self);
+        friend var            _lead_(const stream& self);
+        friend var            _next_(const stream& self);
+    };
+
+    /********************************************************************************************/
+    //
+    //                                 'stream' Class Implementation
+    //
+    /********************************************************************************************/
+
+    stream::stream() : _state(evaluated), _operation(operation::none), _head(), _tail(), _rest(), _count(0)
+#if defined(OLLY_CACHED_HASH)
+        , _hashed(false), _hash(0), _reverse(0), _power(0)
+#endif
+    {
+    }
+
+    stream::stream(var x, var next)
+        : _state(evaluated), _operation(operation::none), _head(std::move(x)), _tail(std::move(next)), _rest(), _count(0)
+#if defined(OLLY_CACHED_HASH)
+        , _hashed(false), _hash(0), _reverse(0), _power(0)
+#endif
+    {
+    }
+
+    stream::stream(operation op, var a, var b, var c, std::size_t n)
+        : _state(suspended), _operation(op), _head(std::move(a)), _tail(std::move(b)), _rest(std::move(c)), _count(n)
+#if defined(OLLY_CACHED_HASH)
+        , _hashed(false), _hash(0), _reverse(0), _power(0)
+#endif
+    {
+    }
+
+    stream::stream(const stream& other) : _state(evaluated), _operation(operation::none), _head(), _tail(), _rest(), _count(0)
+#if defined(OLLY_CACHED_HASH)
+        , _hashed(false), _hash(0), _reverse(0), _power(0)
+#endif
+    {
+
+        other.evaluate();
+
+        _head = other._head;
+        _tail = other._tail;
+    }
+
+    stream::stream(stream&& other) noexcept
+        : _state(other._state.load(std::memory_order_relaxed)), _operation(other._operation),
+          _head(std::move(other._head)), _tail(std::move(other._tail)), _rest(std::move(other._rest)), _count(other._count)
+#if defined(OLLY_CACHED_HASH)
+        , _hashed(false), _hash(0), _reverse(0), _power(0)
+#endif
+    {
+    }
+
+    stream::~stream() {
+        /*
+            Release the cells only this cell references in a loop,
+            as 'node' does.  A suspended cell may reference more
+            than one stream, so those still to be released are
+            held on a stack.  Once the reclaimer's step is reached
+            the rest are deferred.
+        */
+
+        auto owned = [](const var& s) {
+            return s.is<stream>() && s.unique();
+        };
+
+        if (!owned(_head) && !owned(_tail) && !owned(_rest)) {
+            return;
+        }
+
+        const std::size_t limit = reclaimer::step();
+
+        std::size_t cells = 0;
+
+        std::vector<var> pending;
+
+        auto unlink = [&](var& s) {
+            if (owned(s)) {
+                pending.push_back(std::move(s));
+            }
+        };
+
+        unlink(_head);
+        unlink(_tail);
+        unlink(_rest);
+
+        while (!pending.empty()) {
+
+            var next = std::move(pending.back());
+
+            pending.pop_back();
+
+            if (!owned(next)) {
+                continue;
+            }
+
+            if (cells == limit) {
+
+                reclaimer::defer(std::move(next));
+
+                continue;
+            }
+
+            auto cell = const_cast<stream*>(next.cast<stream>().get());
+
+            unlink(cell->_head);
+            unlink(cell->_tail);
+            unlink(cell->_rest);
+
+            cells += 1;
+        }
+
+        reclaimer::released(cells);
+    }
+
+    void stream::evaluate() const {
+        /*
+            The first thread to read a suspended cell forces it,
+            and any other waits for the result.  A cell is never
+            forced by the cells it depends on, so none waits on
+            itself.
+        */
+
+        if (_state.load(std::memory_order_acquire) == evaluated) {
+            return;
+        }
+
+        std::uint8_t expected = suspended;
+
+        if (!_state.compare_exchange_strong(expected, forcing, std::memory_order_acquire)) {
+
+            while (_state.load(std::memory_order_acquire) != evaluated) {
+                std::this_thread::yield();
+            }
+
+            return;
+        }
+
+        try {
+
+            var head;
+            var tail;
+
+            evaluate(_operation, _head, _tail, _rest, _count, head, tail);
+
+            _head      = std::move(head);
+            _tail      = std::move(tail);
+            _rest      = var();
+            _count     = 0;
+            _operation = operation::none;
+        }
+        catch (...) {
+
+            _state.store(suspended, std::memory_order_release);
+
+            throw;
+        }
+
+        _state.store(evaluated, std::memory_order_release);
+    }
+
+    void stream::evaluate(operation op, const var& a, const var& b, const var& c, std::size_t n, var& head, var& tail) {
+        /*
+            Each operation forces the first cell of its argument
+            and suspends the rest.  The rotations are those of the
+            real time deque.
+
+                rotate_reverse(f, r, a) = f ++ reverse(r) ++ a
+                rotate_drop(f, n, r)    = f ++ reverse(drop(n, r))
+
+            Each cell of 'f' moves 'rotation_step' cells of 'r'
+            onto 'a', so 'r' is exhausted with 'f' when it is no
+            more than 'rotation_step' times as long.  The cells
+            moved are reversed onto 'a' at once, rather than
+            appended to it lazily, as there are only a few.
+        */
+
+        switch (op) {
+
+            case operation::take: {
+
+                auto x = force(a);
+
+                if (x) {
+                    head = x->_head;
+                    tail = take(n - 1, x->_tail);
+                }
+
+                break;
+            }
+
+            case operation::rotate_reverse: {
+
+                auto x = force(a);
+
+                if (x) {
+                    head = x->_head;
+                    tail = rotate_reverse(x->_tail, drop(rotation_step, b), reverse(b, rotation_step, c));
+                }
+                else {
+                    evaluate(reverse(b, std::numeric_limits<std::size_t>::max(), c), head, tail);
+                }
+
+                break;
+            }
+
+            case operation::rotate_drop: {
+
+                auto x = force(a);
+
+                if (n < rotation_step || !x) {
+                    evaluate(operation::rotate_reverse, a, drop(n, b), var(), 0, head, tail);
+                }
+                else {
+                    head = x->_head;
+                    tail = rotate_drop(x->_tail, n - rotation_step, drop(rotation_step, b));
+                }
+
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    void stream::evaluate(const var& s, var& head, var& tail) {
+
+        auto x = force(s);
+
+        if (x) {
+            head = x->_head;
+            tail = x->_tail;
+        }
+    }
+
+    const stream* stream::forced() const {
+
+        evaluate();
+
+        return _head.is_something() ? this : nullptr;
+    }
+
+    var stream::cons(var x, var s) {
+        return stream(std::move(x), std::move(s));
+    }
+
+    var stream::take(std::size_t n, var s) {
+
+        if (!n || s.is_nothing()) {
+            return var();
+        }
+
+        return stream(operation::take, std::move(s), var(), var(), n);
+    }
+
+    var stream::drop(std::size_t n, var s) {
+
+        while (n--) {
+
+            auto x = force(s);
+
+            if (!x) {
+                return var();
+            }
+
+            s = x->_tail;
+        }
+
+        return s;
+    }
+
+    var stream::reverse(var s, std::size_t n, var a) {
+
+        while (n--) {
+
+            auto x = force(s);
+
+            if (!x) {
+                break;
+            }
+
+            a = cons(x->_head, std::move(a));
+            s = x->_tail;
+        }
+
+        return a;
+    }
+
+    var stream::rotate_reverse(var f, var r, var a) {
+        return stream(operation::rotate_reverse, std::move(f), std::move(r), std::move(a), 0);
+    }
+
+    var stream::rotate_drop(var f, std::size_t n, var r) {
+        return stream(operation::rotate_drop, std::move(f), std::move(r), var(), n);
+    }
+
+    var stream::split(var& s, std::size_t n) {
+        /*
+            Cut the link following the first 'n' cells in place,
+            unless a cell before it is shared.  That cell and the
+            rest before the cut are then copied, and the copy cut.
+        */
+
+        var* link = &s;
+
+        for (; n; --n) {
+
+            auto x = force(*link);
+
+            if (!x) {
+                return var();
+            }
+
+            if (!link->unique()) {
+
+                var rest = drop(n, *link);
+
+                *link = reverse_in_place(reverse(*link, n, var()), var());
+
+                return rest;
+            }
+
+#if defined(OLLY_CACHED_HASH)
+            x->_hashed.store(false, std::memory_order_relaxed);
+#endif
+
+            link = &x->_tail;
+        }
+
+        return std::exchange(*link, var());
+    }
+
+    var stream::reverse_in_place(var s, var a) {
+
+        while (auto x = force(s)) {
+
+            if (s.unique()) {
+
+                var next = std::move(x->_tail);
+
+#if defined(OLLY_CACHED_HASH)
+                x->_hashed.store(false, std::memory_order_relaxed);
+#endif
+
+                x->_tail = std::move(a);
+                a        = std::move(s);
+                s        = std::move(next);
+            }
+            else {
+
+                a = cons(x->_head, std::move(a));
+                s = x->_tail;
+            }
+        }
+
+        return a;
+    }
+
+    const stream* stream::force(const var& s) {
+
+        auto cell = s.cast<stream>();
+
+        return cell ? cell->forced() : nullptr;
+    }
+
+    var stream::advance(const var& s) {
+
+        auto x = force(s);
+
+        return x ? x->_tail : var();
+    }
+
+#if defined(OLLY_CACHED_HASH)
+    stream::hashes stream::hash(const var& s) {
+        /*
+            The cells are walked to the first already hashed, and
+            each before it is then hashed from the last back.  As
+            with 'node', the hash of a cell followed by a stream
+            only needs the hash and the power of that stream.
+
+                H(x : t) = H(t) + (hash_combine(seed, x) - seed) * B^|t|
+                R(x : t) = hash_combine(R(t), x)
+        */
+
+        std::vector<const stream*> pending;
+
+        auto x = force(s);
+
+        while (x && !x->_hashed.load(std::memory_order_acquire)) {
+
+            pending.push_back(x);
+
+            x = force(x->_tail);
+        }
+
+        hashes h = { hash_seed, hash_seed, 1 };
+
+        if (x) {
+            h = { x->_hash.load(std::memory_order_relaxed), x->_reverse.load(std::memory_order_relaxed), x->_power.load(std::memory_order_relaxed) };
+        }
+
+        while (!pending.empty()) {
+
+            x = pending.back();
+
+            pending.pop_back();
+
+            const std::uint64_t v = x->_head.hash();
+
+            h.hash    = h.hash + (hash_combine(hash_seed, v) - hash_seed) * h.power;
+            h.reverse = hash_combine(h.reverse, v);
+            h.power   = h.power * hash_multiplier;
+
+            x->_hash.store(h.hash, std::memory_order_relaxed);
+            x->_reverse.store(h.reverse, std::memory_order_relaxed);
+            x->_power.store(h.power, std::memory_order_relaxed);
+            x->_hashed.store(true, std::memory_order_release);
+        }
+
+        return h;
+    }
+
+    bool stream::hashed(const var& s) {
+
+        auto cell = s.cast<stream>();
+
+        return !cell || cell->_hashed.load(std::memory_order_acquire);
+    }
+#endif
+
+    const var& stream::head() const {
+        return _head;
+    }
+
+    const var& stream::tail() const {
+        return _tail;
+    }
+
+    template <typename F>
+    void stream::each(F&& f) const {
+
+        for (const stream* a = forced(); a; a = force(a->_tail)) {
+            f(a->_head);
+        }
+    }
+
+    template <typename F>
+    void stream::each_reversed(F&& f) const {
+        /*
+            Visit the stream backwards as 'node' does, marking
+            a cell in every block of about the square root of
+            its length, and visiting each block in reverse.
+        */
+
+        static constexpr std::size_t local_cells = 64;
+
+        std::size_t length = 0;
+
+        for (const stream* a = forced(); a; a = force(a->_tail)) {
+            ++length;
+        }
+
+        if (length <= local_cells) {
+
+            const stream* cells[local_cells];
+
+            std::size_t i = 0;
+
+            for (const stream* a = forced(); a; a = force(a->_tail)) {
+                cells[i++] = a;
+            }
+
+            while (i) {
+                f(cells[--i]->_head);
+            }
+
+            return;
+        }
+
+        const std::size_t block = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(length))));
+
+        std::vector<const stream*> marks;
+        std::vector<const stream*> cells;
+
+        marks.reserve(length / block + 1);
+        cells.reserve(block);
+
+        std::size_t i = 0;
+
+        for (const stream* a = forced(); a; a = force(a->_tail), ++i) {
+
+            if (i % block == 0) {
+                marks.push_back(a);
+            }
+        }
+
+        for (auto mark = marks.rbegin(); mark != marks.rend(); ++mark) {
+
+            cells.clear();
+
+            const stream* a = *mark;
+
+            for (std::size_t j = 0; j < block && a; ++j, a = force(a->_tail)) {
+                cells.push_back(a);
+            }
+
+            for (auto cell = cells.rbegin(); cell != cells.rend(); ++cell) {
+                f((*cell)->_head);
+            }
+        }
+    }
+
+    template <typename F>
+    bool stream::all_reversed(std::size_t n, F&& f) const {
+        /*
+            Visit the second half of the cells before the first,
+            recursively, so that only the depth of the recursion
+            is held rather than a mark for each block.  It takes
+            time in proportion to n log n, without allocating.
+        */
+
+        static constexpr std::size_t local_cells = 64;
+
+        if (n <= local_cells) {
+
+            const stream* cells[local_cells];
+
+            std::size_t i = 0;
+
+            for (const stream* a = forced(); a && i < n; a = force(a->_tail)) {
+                cells[i++] = a;
+            }
+
+            while (i) {
+
+                if (!f(cells[--i]->_head)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        const std::size_t half = n / 2;
+
+        const stream* middle = forced();
+
+        for (std::size_t i = 0; middle && i < half; ++i) {
+            middle = force(middle->_tail);
+        }
+
+        if (middle && !middle->all_reversed(n - half, f)) {
+            return false;
+        }
+
+        return all_reversed(half, f);
+    }
+
+    std::string _type_(const stream& self) {
+        return "stream";
+    }
+
+    bool _is_(const stream& self) {
+        return self.forced();
+    }
+
+    void _str_(Text_Stream& out, const stream& self) {
+
+        const char* separator = "";  // Written before every element but the first.
+
+        self.each([&](const var& x) {
+            out << separator;
+
+            x.str(out);
+
+            separator = " ";
+        });
+    }
+
+    void _repr_(Text_Stream& out, const stream& self) {
+
+        const char* separator = "";  // Written before every element but the first.
+
+        self.each([&](const var& x) {
+            out << separator;
+
+            x.repr(out);
+
+            separator = " ";
+        });
+    }
+
+    std::size_t _size_(const stream& self) {
+
+        std::size_t size = 0;
+
+        self.each([&](const var&) {
+            ++size;
+        });
+
+        return size;
+    }
+
+    var _lead_(const stream& self) {
+
+        auto x = self.forced();
+
+        return x ? x->head() : var();
+    }
+
+    var _next_(const stream& self) {
+
+        auto x = self.forced();
+
+        if (x && x->tail().is_something()) {
+            return x->tail();
+        }
+
+        return stream();
+    }
+}
@@ -35,15 +35,35 @@
 #if __cplusplus >= 202002L
 #include <format>
 #endif
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <compare>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <iosfwd>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <ranges>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <typeinfo>
 #include <typeindex>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -70,8 +90,10 @@ namespace Olly {
     //
     /********************************************************************************************/
 
+    class text_writer;  // Defined in 'text_writer.h'.
+
     using Text        = std::string;
-    using Text_Stream = std::stringstream;
+    using Text_Stream = text_writer;
     using Text_Tokens = std::vector<Text>;
 
     static const double NOT_A_NUMBER = std::numeric_limits<double>::quiet_NaN();
@@ -91,4 +113,15 @@ namespace Olly {
     public:
         static const bool value = decltype(test<S, T>(0))::value;
     };
+
+    /*
+        Selects the constructors which take the elements of a
+        range, rather than the range itself as one element.
+    */
+
+    struct from_range_t {
+        explicit from_range_t() = default;
+    };
+
+    inline constexpr from_range_t from_range{};
 }
\ No newline at end of file
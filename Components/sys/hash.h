@@ -0,0 +1,179 @@
+#pragma once
+
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+
+#include "base_type_definitions.h"
+
+namespace Olly {
+
+    /********************************************************************************************/
+    //
+    //                                      Hashing
+    //
+    //          Fast native hashes for arithmetic types and strings, used in place of
+    //          hashing the representation of an object.  Every hash is seeded, and the
+    //          algorithm never depends upon the process or the standard library, so a
+    //          hash is reproducible across processes and may be used for sharding.
+    //
+    //          Collections hash their elements in order, folding each into the hash
+    //          with 'hash_combine'.  It is a polynomial in 'hash_multiplier', so the
+    //          hash of two joined sequences can be computed from the hashes of each.
+    //
+    /********************************************************************************************/
+
+    static constexpr std::uint64_t hash_seed       = 0x9E3779B97F4A7C15ULL;   // The default seed.
+    static constexpr std::uint64_t hash_multiplier = 0x100000001B3ULL;        // The base of 'hash_combine'.
+
+    constexpr std::uint64_t hash_mix(std::uint64_t x);                            // Scatter the bits of a word.
+    constexpr std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t h);  // Fold a hash into a seed.
+
+    std::uint64_t hash_bytes(const void* data, std::size_t size, std::uint64_t seed = hash_seed);
+
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T>, std::uint64_t>
+    hash_value(T x, std::uint64_t seed = hash_seed);
+
+    std::uint64_t hash_value(double x,             std::uint64_t seed = hash_seed);
+    std::uint64_t hash_value(float x,              std::uint64_t seed = hash_seed);
+    std::uint64_t hash_value(std::string_view x,   std::uint64_t seed = hash_seed);
+    std::uint64_t hash_value(const Text& x,        std::uint64_t seed = hash_seed);
+    std::uint64_t hash_value(const char* x,        std::uint64_t seed = hash_seed);
+
+    template <typename T, typename = void>
+    constexpr bool has_hash_value = false;   // Can the type be hashed natively.
+
+    template <typename T>
+    constexpr bool has_hash_value<T, std::void_t<decltype(hash_value(std::declval<const T&>()))>> = true;
+
+    /********************************************************************************************/
+    //
+    //                                 Hashing Implementation
+    //
+    /********************************************************************************************/
+
+    constexpr std::uint64_t hash_mix(std::uint64_t x) {
+        /*
+            The finalizer of MurmurHash3.
+        */
+
+        x ^= x >> 33;
+        x *= 0xFF51AFD7ED558CCDULL;
+        x ^= x >> 33;
+        x *= 0xC4CEB9FE1A85EC53ULL;
+        x ^= x >> 33;
+
+        return x;
+    }
+
+    constexpr std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t h) {
+        return seed * hash_multiplier + h;
+    }
+
+    std::uint64_t hash_bytes(const void* data, std::size_t size, std::uint64_t seed) {
+        /*
+            Words are read in little endian order one byte at a
+            time, so the hash is the same on every platform.
+        */
+
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+
+        std::uint64_t h = hash_mix(seed ^ (size * hash_multiplier));
+
+        while (size >= 8) {
+
+            std::uint64_t word = 0;
+
+            for (std::size_t i = 0; i < 8; ++i) {
+                word |= static_cast<std::uint64_t>(p[i]) << (i * 8);
+            }
+
+            h = hash_mix(h ^ word) * hash_multiplier;
+
+            p    += 8;
+            size -= 8;
+        }
+
+        std::uint64_t tail = 0;
+
+        for (std::size_t i = 0; i < size; ++i) {
+            tail |= static_cast<std::uint64_t>(p[i]) << (i * 8);
+        }
+
+        return hash_mix(h ^ tail);
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T>, std::uint64_t>
+    hash_value(T x, std::uint64_t seed) {
+        /*
+            Integers of equal value hash equally, whatever
+            their width or signedness.
+        */
+
+        return hash_mix(seed ^ hash_mix(static_cast<std::uint64_t>(x)));
+    }
+
+    std::uint64_t hash_value(double x, std::uint64_t seed) {
+
+        if (x == 0.0) {
+            x = 0.0;  // Both zeros are equal, so must hash equally.
+        }
+
+        if (std::isnan(x)) {
+            x = NOT_A_NUMBER;
+        }
+
+        std::uint64_t bits;
+
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        return hash_mix(seed ^ hash_mix(bits));
+    }
+
+    std::uint64_t hash_value(float x, std::uint64_t seed) {
+        return hash_value(static_cast<double>(x), seed);
+    }
+
+    std::uint64_t hash_value(std::string_view x, std::uint64_t seed) {
+        return hash_bytes(x.data(), x.size(), seed);
+    }
+
+    std::uint64_t hash_value(const Text& x, std::uint64_t seed) {
+        return hash_bytes(x.data(), x.size(), seed);
+    }
+
+    std::uint64_t hash_value(const char* x, std::uint64_t seed) {
+        return hash_value(std::string_view(x), seed);
+    }
+}
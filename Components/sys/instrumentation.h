@@ -0,0 +1,431 @@
+#pragma once
+
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+
+#include "base_type_definitions.h"
+
+namespace Olly {
+
+    /********************************************************************************************/
+    //
+    //                                    Instrumentation
+    //
+    //          Opt-in counters used to measure the cost of the 'var' machinery.  They
+    //          are only compiled when OLLY_INSTRUMENTATION is defined, and otherwise
+    //          leave no trace in the library.
+    //
+    /********************************************************************************************/
+
+#if defined(OLLY_INSTRUMENTATION)
+
+    class ref_count_stats {
+
+        /********************************************************************************************/
+        //
+        //       Counts every reference a boxed 'var' retains or releases, in all threads.
+        //
+        /********************************************************************************************/
+
+    public:
+
+        static void          retained();
+        static void          released();
+
+        static std::uint64_t retains();
+        static std::uint64_t releases();
+        static void          reset();
+
+    private:
+
+        static std::atomic<std::uint64_t>& retain_count();
+        static std::atomic<std::uint64_t>& release_count();
+    };
+
+    void ref_count_stats::retained() {
+        retain_count().fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void ref_count_stats::released() {
+        release_count().fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t ref_count_stats::retains() {
+        return retain_count().load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t ref_count_stats::releases() {
+        return release_count().load(std::memory_order_relaxed);
+    }
+
+    void ref_count_stats::reset() {
+        retain_count().store(0, std::memory_order_relaxed);
+        release_count().store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic<std::uint64_t>& ref_count_stats::retain_count() {
+
+        static std::atomic<std::uint64_t> count(0);
+
+        return count;
+    }
+
+    std::atomic<std::uint64_t>& ref_count_stats::release_count() {
+
+        static std::atomic<std::uint64_t> count(0);
+
+        return count;
+    }
+
+    class text_cache_stats {
+
+        /********************************************************************************************/
+        //
+        //       Counts every conversion to text served from, or missing, a cached text.
+        //
+        /********************************************************************************************/
+
+    public:
+
+        static void          hit();
+        static void          missed();
+
+        static std::uint64_t hits();
+        static std::uint64_t misses();
+        static double        hit_rate();   // The share of conversions served from a cache.
+        static void          reset();
+
+    private:
+
+        static std::atomic<std::uint64_t>& hit_count();
+        static std::atomic<std::uint64_t>& miss_count();
+    };
+
+    void text_cache_stats::hit() {
+        hit_count().fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void text_cache_stats::missed() {
+        miss_count().fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t text_cache_stats::hits() {
+        return hit_count().load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t text_cache_stats::misses() {
+        return miss_count().load(std::memory_order_relaxed);
+    }
+
+    double text_cache_stats::hit_rate() {
+
+        const double total = static_cast<double>(hits() + misses());
+
+        return total ? static_cast<double>(hits()) / total : 0.0;
+    }
+
+    void text_cache_stats::reset() {
+        hit_count().store(0, std::memory_order_relaxed);
+        miss_count().store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic<std::uint64_t>& text_cache_stats::hit_count() {
+
+        static std::atomic<std::uint64_t> count(0);
+
+        return count;
+    }
+
+    std::atomic<std::uint64_t>& text_cache_stats::miss_count() {
+
+        static std::atomic<std::uint64_t> count(0);
+
+        return count;
+    }
+
+    class allocation_stats {
+
+        /********************************************************************************************/
+        //
+        //       Counts every object a 'var' boxes, and every one destroyed, for each type.
+        //       Every object of a type is the same size, so bytes and the histogram of
+        //       allocation sizes are derived from the counts when queried.
+        //
+        /********************************************************************************************/
+
+    public:
+
+        struct counters {
+            const Text*                name;
+            std::size_t                type_id;
+            std::size_t                size;          // The bytes of each object.
+            std::atomic<std::uint64_t> allocations;
+            std::atomic<std::uint64_t> frees;
+        };
+
+        struct record {                               // A snapshot of the counters of a type.
+            Text          name;
+            std::size_t   type_id;
+            std::size_t   size;
+            std::uint64_t allocations;
+            std::uint64_t live_objects;
+            std::uint64_t live_bytes;
+        };
+
+        static constexpr std::size_t histogram_buckets = 16;   // Sizes up to each power of two, from 16 bytes.
+
+        static counters&           track(std::size_t type_id, const Text& name, std::size_t size);
+        static void                allocated(counters& type);
+        static void                freed(counters& type);
+
+        static std::vector<record> by_type();                   // Sorted by live bytes, largest first.
+        static std::uint64_t       allocations();
+        static std::uint64_t       live_objects();
+        static std::uint64_t       live_bytes();
+        static std::vector<std::uint64_t> histogram();          // Allocations with sizes up to 16 << i bytes.
+
+        static void                write_json(std::ostream& out);
+        static Text                json();
+        static void                reset();
+
+    private:
+
+        static std::mutex&              types_lock();
+        static std::vector<counters*>&  types();
+    };
+
+    allocation_stats::counters& allocation_stats::track(std::size_t type_id, const Text& name, std::size_t size) {
+        /*
+            Counters are never freed, so each type may hold
+            a reference to its own for the life of the process.
+        */
+
+        counters* type = new counters{ &name, type_id, size, { 0 }, { 0 } };
+
+        std::lock_guard<std::mutex> lock(types_lock());
+
+        types().push_back(type);
+
+        return *type;
+    }
+
+    void allocation_stats::allocated(counters& type) {
+        type.allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void allocation_stats::freed(counters& type) {
+        type.frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::vector<allocation_stats::record> allocation_stats::by_type() {
+
+        std::vector<record> records;
+        {
+            std::lock_guard<std::mutex> lock(types_lock());
+
+            for (const counters* type : types()) {
+
+                std::uint64_t frees       = type->frees.load(std::memory_order_relaxed);
+                std::uint64_t allocations = type->allocations.load(std::memory_order_relaxed);
+                std::uint64_t live        = allocations > frees ? allocations - frees : 0;
+
+                records.push_back({ *type->name, type->type_id, type->size, allocations, live, live * type->size });
+            }
+        }
+
+        std::sort(records.begin(), records.end(), [](const record& a, const record& b) {
+            return a.live_bytes != b.live_bytes ? a.live_bytes > b.live_bytes : a.type_id < b.type_id;
+        });
+
+        return records;
+    }
+
+    std::uint64_t allocation_stats::allocations() {
+
+        std::uint64_t count = 0;
+
+        for (const record& type : by_type()) {
+            count += type.allocations;
+        }
+
+        return count;
+    }
+
+    std::uint64_t allocation_stats::live_objects() {
+
+        std::uint64_t count = 0;
+
+        for (const record& type : by_type()) {
+            count += type.live_objects;
+        }
+
+        return count;
+    }
+
+    std::uint64_t allocation_stats::live_bytes() {
+
+        std::uint64_t bytes = 0;
+
+        for (const record& type : by_type()) {
+            bytes += type.live_bytes;
+        }
+
+        return bytes;
+    }
+
+    std::vector<std::uint64_t> allocation_stats::histogram() {
+
+        std::vector<std::uint64_t> buckets(histogram_buckets, 0);
+
+        for (const record& type : by_type()) {
+
+            std::size_t i = 0;
+
+            while (i + 1 < histogram_buckets && (std::size_t(16) << i) < type.size) {
+                ++i;
+            }
+
+            buckets[i] += type.allocations;
+        }
+
+        return buckets;
+    }
+
+    void allocation_stats::write_json(std::ostream& out) {
+
+        auto quoted = [&out](const Text& text) {
+
+            out << '"';
+
+            for (char c : text) {
+
+                if (c == '"' || c == '\\') {
+                    out << '\\' << c;
+                }
+                else if (static_cast<unsigned char>(c) < 0x20) {
+
+                    const char* digits = "0123456789abcdef";
+
+                    out << "\\u00" << digits[(c >> 4) & 0xF] << digits[c & 0xF];
+                }
+                else {
+                    out << c;
+                }
+            }
+
+            out << '"';
+        };
+
+        std::vector<record> records = by_type();
+
+        std::uint64_t allocations = 0;
+        std::uint64_t objects     = 0;
+        std::uint64_t bytes       = 0;
+
+        for (const record& type : records) {
+            allocations += type.allocations;
+            objects     += type.live_objects;
+            bytes       += type.live_bytes;
+        }
+
+        out << "{\"allocations\":" << allocations
+            << ",\"live_objects\":" << objects
+            << ",\"live_bytes\":" << bytes
+            << ",\"histogram\":[";
+
+        std::vector<std::uint64_t> buckets = histogram();
+
+        for (std::size_t i = 0; i < buckets.size(); ++i) {
+            out << (i ? "," : "") << "{\"size\":" << (std::size_t(16) << i) << ",\"allocations\":" << buckets[i] << "}";
+        }
+
+        out << "],\"types\":[";
+
+        for (std::size_t i = 0; i < records.size(); ++i) {
+
+            const record& type = records[i];
+
+            out << (i ? "," : "") << "{\"type\":";
+
+            quoted(type.name);
+
+            out << ",\"type_id\":"      << type.type_id
+                << ",\"size\":"         << type.size
+                << ",\"allocations\":"  << type.allocations
+                << ",\"live_objects\":" << type.live_objects
+                << ",\"live_bytes\":"   << type.live_bytes << "}";
+        }
+
+        out << "]}";
+    }
+
+    Text allocation_stats::json() {
+
+        std::ostringstream out;
+
+        write_json(out);
+
+        return out.str();
+    }
+
+    void allocation_stats::reset() {
+        /*
+            Live objects are kept, as they are still to be freed.
+        */
+
+        std::lock_guard<std::mutex> lock(types_lock());
+
+        for (counters* type : types()) {
+
+            std::uint64_t frees = type->frees.exchange(0, std::memory_order_relaxed);
+
+            type->allocations.fetch_sub(frees, std::memory_order_relaxed);
+        }
+    }
+
+    std::mutex& allocation_stats::types_lock() {
+
+        static std::mutex* lock = new std::mutex();
+
+        return *lock;
+    }
+
+    std::vector<allocation_stats::counters*>& allocation_stats::types() {
+
+        static auto* list = new std::vector<counters*>();
+
+        return *list;
+    }
+
+#endif
+}
@@ -0,0 +1,763 @@
+#pragma once
+
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include "base_type_definitions.h"
+
+namespace Olly {
+
+    /********************************************************************************************/
+    //
+    //                                'block_pool' Class Definition
+    //
+    //          A size class allocator for the small, fixed size objects boxed by a 'var'.
+    //          Requests are rounded up to a multiple of 'granularity', and each size
+    //          class is carved from chunks of 'chunk_size' bytes aligned to their size,
+    //          so the chunk of any block is found by masking its address.
+    //
+    //          Every thread allocates from a heap of its own, without locking.  Blocks
+    //          freed by the thread owning their heap return to its free lists.  Blocks
+    //          freed by any other thread are pushed onto an atomic list of the owning
+    //          heap, which the owner collects once a free list runs dry.  The heap of
+    //          an exiting thread is abandoned, and adopted by the next thread to start.
+    //          Threads allocating while they exit share a single heap under a lock.
+    //
+    //          Requests larger than 'max_block', or aligned beyond 'granularity', are
+    //          passed on to the global operator new.  Chunks are cut from slabs of
+    //          'slab_chunks' chunks, which are kept for the life of the process and
+    //          never returned to the system.
+    //
+    //          While a 'region' is open on a thread, the blocks it allocates are bumped
+    //          from the chunks of the region's arena instead.  Freeing one only counts
+    //          it, and the arena is released whole once its region has closed and every
+    //          block of it has been freed.
+    //
+    /********************************************************************************************/
+
+    class region;
+
+    class block_pool {
+
+    public:
+
+        static constexpr std::size_t granularity  = 16;
+        static constexpr std::size_t max_block    = 512;
+        static constexpr std::size_t size_classes = max_block / granularity;
+        static constexpr std::size_t chunk_size   = 64 * 1024;
+        static constexpr std::size_t slab_chunks  = 32;
+
+        static void*  allocate(std::size_t size, std::size_t align = alignof(std::max_align_t));
+        static void deallocate(void* block, std::size_t size, std::size_t align = alignof(std::max_align_t)) noexcept;
+
+        static void    collect();   // Return the blocks other threads freed to the calling thread's heap.
+
+    private:
+
+        friend class region;
+
+        struct free_block {
+            free_block* next;
+        };
+
+        struct heap;
+        struct arena;
+
+        struct chunk {
+            heap*       owner;        // Null for the chunks of an arena.
+            std::size_t size_class;
+            arena*      region;       // The arena of the chunk, if any.
+            chunk*      next;         // The chunk taken before it by the same arena.
+        };
+
+        struct size_class_cache {
+            free_block* free  = nullptr;   // Blocks freed by the owning thread.
+            char*       bump  = nullptr;   // The next block never allocated, within the current chunk.
+            char*       end   = nullptr;
+        };
+
+        struct heap {
+            size_class_cache         classes[size_classes];
+            std::atomic<free_block*> remote{ nullptr };     // Blocks freed by other threads.
+            char*                    slab     = nullptr;    // The next chunk never used, within the current slab.
+            char*                    slab_end = nullptr;
+        };
+
+        struct arena {
+            std::pmr::memory_resource*  upstream = nullptr;  // Null for chunks taken from the pool.
+            const void*                 owner    = nullptr;  // The thread which opened the region.
+            bool                        open     = true;
+            std::size_t                 owned    = 0;        // Blocks allocated, less those the owner freed while open.
+            std::atomic<std::size_t>    shared{ open_bias }; // Less the blocks freed by other threads, or once closed.
+            char*                       bump     = nullptr;  // The next free byte, within the current chunk.
+            char*                       end      = nullptr;
+            chunk*                      chunks   = nullptr;  // The chunk taken last.
+        };
+
+        class thread_heap;
+
+        static constexpr std::size_t header_size = (sizeof(chunk) + granularity - 1) / granularity * granularity;
+        static constexpr std::size_t open_bias   = std::size_t(1) << (std::numeric_limits<std::size_t>::digits - 2);
+
+        static bool         pooled(std::size_t size, std::size_t align);
+        static std::size_t  class_of(std::size_t size);
+        static std::size_t  block_size(std::size_t size_class);
+        static chunk*       chunk_of(const void* block);
+
+        static void*        take(heap& h, std::size_t size_class);
+        static void         refill(heap& h, std::size_t size_class);
+        static char*        new_chunk(heap& h);
+        static void         collect(heap& h);
+        static void         give_back(heap& h, void* block) noexcept;
+
+        static arena*       open_arena(std::pmr::memory_resource* upstream);
+        static void         close_arena(arena* a) noexcept;
+        static void*        bump(arena& a, std::size_t size);
+        static void         grow(arena& a);
+        static void         release(arena& a) noexcept;       // Count a block freed, releasing the arena with the last.
+        static void         free_arena(arena& a) noexcept;
+        static arena*&      current_arena();                  // The arena of the calling thread's innermost region.
+
+        static char*        take_chunk(std::pmr::memory_resource* upstream);
+        static void         give_chunk(chunk* c, std::pmr::memory_resource* upstream) noexcept;
+        static std::vector<chunk*>& spare_chunks();           // Chunks released by arenas, awaiting reuse.
+
+        static heap*        local_heap();      // The calling thread's heap, or null while it exits.
+        static heap*&       current();
+        static bool&        exiting();
+
+        static std::mutex&          shared_lock();
+        static heap&                shared_heap();   // The heap of threads allocating while they exit.
+        static std::vector<heap*>&  abandoned();     // Heaps of exited threads, awaiting a new owner.
+    };
+
+    class block_pool::thread_heap {
+
+        /********************************************************************************************/
+        //
+        //       Owns a heap for the life of the calling thread, adopting an abandoned one if any.
+        //
+        /********************************************************************************************/
+
+    public:
+
+        thread_heap();
+        ~thread_heap();
+
+        heap* owned;
+    };
+
+    /********************************************************************************************/
+    //
+    //                                  'region' Class Definition
+    //
+    //          A scope within which the calling thread allocates every pooled block,
+    //          and so every object a 'var' boxes, from a bump arena.  Chunks of the
+    //          arena are taken from the 'block_pool', or from an upstream
+    //          'std::pmr::memory_resource' if one is given, and are returned all at
+    //          once rather than block by block.  The pool reuses the chunks of
+    //          arenas released, so opening a region rarely touches new memory.
+    //
+    //          Objects built within the region are still destroyed as their last
+    //          reference is released, but freeing them costs a single count.  The
+    //          arena is released when the region closes, unless objects made within
+    //          it have escaped the scope.  Those are detected by 'live()', and the
+    //          arena is then kept until the last of them is freed, by any thread.
+    //
+    //          Regions nest, and must close in the reverse order they were opened on
+    //          the thread opening them.  A region is also a memory resource, so that
+    //          containers may allocate from its arena.  Requests larger than
+    //          'block_pool::max_block' are passed to the upstream resource, or to
+    //          the global operator new.
+    //
+    /********************************************************************************************/
+
+    class region : public std::pmr::memory_resource {
+
+        block_pool::arena*  _arena;
+        block_pool::arena*  _outer;   // The arena active when the region was opened.
+
+    public:
+
+        region(std::pmr::memory_resource* upstream = nullptr);
+        region(const region&) = delete;
+        ~region();
+
+        region& operator=(const region&) = delete;
+
+        std::size_t live()                                              const;  // Objects allocated within the region and not yet freed.
+
+    private:
+
+        std::pmr::memory_resource* upstream()                           const;  // The resource of requests too large to pool.
+
+        void*   do_allocate(std::size_t bytes, std::size_t align)                       override;
+        void    do_deallocate(void* p, std::size_t bytes, std::size_t align)             override;
+        bool    do_is_equal(const std::pmr::memory_resource& other)         const noexcept override;
+    };
+
+    /********************************************************************************************/
+    //
+    //                                'pool_allocator' Class Definition
+    //
+    //          A standard allocator drawing from the 'block_pool', so containers and
+    //          'std::allocate_shared' may share the pool used by every 'var'.
+    //
+    /********************************************************************************************/
+
+    template <typename T>
+    class pool_allocator {
+
+    public:
+
+        using value_type = T;
+
+        pool_allocator() noexcept = default;
+        template <typename U>
+        pool_allocator(const pool_allocator<U>&) noexcept;
+
+        T*      allocate(std::size_t n);
+        void  deallocate(T* p, std::size_t n) noexcept;
+
+        template <typename U>
+        bool operator==(const pool_allocator<U>&)     const noexcept;
+        template <typename U>
+        bool operator!=(const pool_allocator<U>&)     const noexcept;
+    };
+
+    /********************************************************************************************/
+    //
+    //                                'block_pool' Class Implementation
+    //
+    /********************************************************************************************/
+
+    void* block_pool::allocate(std::size_t size, std::size_t align) {
+
+        if (!pooled(size, align)) {
+            return ::operator new(size, std::align_val_t(align));
+        }
+
+        arena* a = current_arena();
+
+        if (a) {
+            return bump(*a, size);
+        }
+
+        heap* h = local_heap();
+
+        if (h) {
+            return take(*h, class_of(size));
+        }
+
+        std::lock_guard<std::mutex> lock(shared_lock());
+
+        return take(shared_heap(), class_of(size));
+    }
+
+    void block_pool::deallocate(void* block, std::size_t size, std::size_t align) noexcept {
+
+        if (!block) {
+            return;
+        }
+
+        if (!pooled(size, align)) {
+            ::operator delete(block, std::align_val_t(align));
+            return;
+        }
+
+        chunk* c = chunk_of(block);
+
+        if (!c->owner) {
+            release(*c->region);
+            return;
+        }
+
+        if (c->owner == current()) {
+
+            free_block* b = static_cast<free_block*>(block);
+
+            b->next = c->owner->classes[c->size_class].free;
+
+            c->owner->classes[c->size_class].free = b;
+
+            return;
+        }
+
+        give_back(*c->owner, block);
+    }
+
+    void block_pool::collect() {
+
+        heap* h = local_heap();
+
+        if (h) {
+            collect(*h);
+        }
+    }
+
+    bool block_pool::pooled(std::size_t size, std::size_t align) {
+        return size && size <= max_block && align <= granularity;
+    }
+
+    std::size_t block_pool::class_of(std::size_t size) {
+        return (size - 1) / granularity;
+    }
+
+    std::size_t block_pool::block_size(std::size_t size_class) {
+        return (size_class + 1) * granularity;
+    }
+
+    block_pool::chunk* block_pool::chunk_of(const void* block) {
+        return reinterpret_cast<chunk*>(reinterpret_cast<std::uintptr_t>(block) & ~std::uintptr_t(chunk_size - 1));
+    }
+
+    void* block_pool::take(heap& h, std::size_t size_class) {
+
+        size_class_cache& cache = h.classes[size_class];
+
+        if (!cache.free && h.remote.load(std::memory_order_relaxed)) {
+            collect(h);
+        }
+
+        if (cache.free) {
+
+            free_block* b = cache.free;
+
+            cache.free = b->next;
+
+            return b;
+        }
+
+        if (cache.bump == cache.end) {
+            refill(h, size_class);
+        }
+
+        void* block = cache.bump;
+
+        cache.bump += block_size(size_class);
+
+        return block;
+    }
+
+    void block_pool::refill(heap& h, std::size_t size_class) {
+
+        char* memory = new_chunk(h);
+
+        new (memory) chunk{ &h, size_class, nullptr, nullptr };
+
+        const std::size_t blocks = (chunk_size - header_size) / block_size(size_class);
+
+        size_class_cache& cache = h.classes[size_class];
+
+        cache.bump = memory + header_size;
+        cache.end  = cache.bump + blocks * block_size(size_class);
+    }
+
+    char* block_pool::new_chunk(heap& h) {
+
+        static_assert((chunk_size & (chunk_size - 1)) == 0, "Chunks must be aligned to a power of two.");
+
+        if (h.slab == h.slab_end) {
+            /*
+                Slabs are aligned by hand, rather than by an aligned
+                operator new per chunk, which some allocators serve
+                by splitting a larger block and leaving fragments.
+            */
+
+            char* slab = static_cast<char*>(::operator new((slab_chunks + 1) * chunk_size));
+
+            h.slab     = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(slab) + chunk_size - 1) & ~std::uintptr_t(chunk_size - 1));
+            h.slab_end = h.slab + slab_chunks * chunk_size;
+        }
+
+        char* memory = h.slab;
+
+        h.slab += chunk_size;
+
+        return memory;
+    }
+
+    void block_pool::collect(heap& h) {
+        /*
+            Only the owner takes the list, and it takes it
+            whole, so a block is never popped while another
+            thread pushes onto it.
+        */
+
+        free_block* b = h.remote.exchange(nullptr, std::memory_order_acquire);
+
+        while (b) {
+
+            free_block* next = b->next;
+
+            size_class_cache& cache = h.classes[chunk_of(b)->size_class];
+
+            b->next    = cache.free;
+            cache.free = b;
+
+            b = next;
+        }
+    }
+
+    void block_pool::give_back(heap& h, void* block) noexcept {
+
+        free_block* b = static_cast<free_block*>(block);
+
+        free_block* head = h.remote.load(std::memory_order_relaxed);
+
+        do {
+            b->next = head;
+        } while (!h.remote.compare_exchange_weak(head, b, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    block_pool::arena* block_pool::open_arena(std::pmr::memory_resource* upstream) {
+        /*
+            The arena is held within its own first chunk, so
+            opening a region allocates nothing else.
+        */
+
+        static constexpr std::size_t arena_size = (sizeof(arena) + granularity - 1) / granularity * granularity;
+
+        char* memory = take_chunk(upstream);
+
+        arena* a = new (memory + header_size) arena();
+
+        a->upstream = upstream;
+        a->owner    = &current_arena();
+        a->chunks   = new (memory) chunk{ nullptr, 0, a, nullptr };
+        a->bump     = memory + header_size + arena_size;
+        a->end      = memory + chunk_size;
+
+        return a;
+    }
+
+    void block_pool::close_arena(arena* a) noexcept {
+        /*
+            Blocks the owner frees while the region is open are
+            counted without atomic operations.  Closing folds its
+            count into the shared count, and removes the bias
+            which kept the shared count from reaching zero.
+        */
+
+        a->open = false;
+
+        const std::size_t delta = a->owned - open_bias;
+
+        if (a->shared.fetch_add(delta, std::memory_order_acq_rel) + delta == 0) {
+            free_arena(*a);
+        }
+    }
+
+    void* block_pool::bump(arena& a, std::size_t size) {
+
+        size = block_size(class_of(size));
+
+        if (static_cast<std::size_t>(a.end - a.bump) < size) {
+            grow(a);
+        }
+
+        void* block = a.bump;
+
+        a.bump  += size;
+        a.owned += 1;
+
+        return block;
+    }
+
+    void block_pool::grow(arena& a) {
+        /*
+            Each chunk is headed, so the blocks of the arena
+            are recognized by their chunk wherever freed.
+        */
+
+        char* memory = take_chunk(a.upstream);
+
+        a.chunks = new (memory) chunk{ nullptr, 0, &a, a.chunks };
+        a.bump   = memory + header_size;
+        a.end    = memory + chunk_size;
+    }
+
+    void block_pool::release(arena& a) noexcept {
+
+        if (a.owner == &current_arena() && a.open) {
+            a.owned -= 1;
+            return;
+        }
+
+        if (a.shared.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            free_arena(a);
+        }
+    }
+
+    void block_pool::free_arena(arena& a) noexcept {
+
+        std::pmr::memory_resource* upstream = a.upstream;
+
+        chunk* c = a.chunks;
+
+        a.~arena();
+
+        while (c) {
+
+            chunk* next = c->next;
+
+            give_chunk(c, upstream);
+
+            c = next;
+        }
+    }
+
+    block_pool::arena*& block_pool::current_arena() {
+
+        thread_local arena* a = nullptr;
+
+        return a;
+    }
+
+    char* block_pool::take_chunk(std::pmr::memory_resource* upstream) {
+
+        if (upstream) {
+            return static_cast<char*>(upstream->allocate(chunk_size, chunk_size));
+        }
+
+        std::lock_guard<std::mutex> lock(shared_lock());
+
+        if (spare_chunks().empty()) {
+            return new_chunk(shared_heap());
+        }
+
+        char* memory = reinterpret_cast<char*>(spare_chunks().back());
+
+        spare_chunks().pop_back();
+
+        return memory;
+    }
+
+    void block_pool::give_chunk(chunk* c, std::pmr::memory_resource* upstream) noexcept {
+
+        if (upstream) {
+            upstream->deallocate(c, chunk_size, chunk_size);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(shared_lock());
+
+        spare_chunks().push_back(c);
+    }
+
+    block_pool::heap* block_pool::local_heap() {
+        /*
+            Blocks allocated while the thread exits come
+            from the shared heap, since its own heap may
+            already have been adopted by another thread.
+        */
+
+        heap* h = current();
+
+        if (h || exiting()) {
+            return h;
+        }
+
+        thread_local thread_heap owner;
+
+        return current();
+    }
+
+    block_pool::heap*& block_pool::current() {
+
+        thread_local heap* h = nullptr;
+
+        return h;
+    }
+
+    bool& block_pool::exiting() {
+
+        thread_local bool flag = false;
+
+        return flag;
+    }
+
+    std::mutex& block_pool::shared_lock() {
+
+        static std::mutex* lock = new std::mutex();
+
+        return *lock;
+    }
+
+    block_pool::heap& block_pool::shared_heap() {
+
+        static heap* h = new heap();
+
+        return *h;
+    }
+
+    std::vector<block_pool::chunk*>& block_pool::spare_chunks() {
+
+        static auto* chunks = new std::vector<chunk*>();
+
+        return *chunks;
+    }
+
+    std::vector<block_pool::heap*>& block_pool::abandoned() {
+
+        static auto* heaps = new std::vector<heap*>();
+
+        return *heaps;
+    }
+
+    /********************************************************************************************/
+    //
+    //                          'block_pool::thread_heap' Class Implementation
+    //
+    /********************************************************************************************/
+
+    block_pool::thread_heap::thread_heap() : owned(nullptr) {
+        {
+            std::lock_guard<std::mutex> lock(shared_lock());
+
+            if (!abandoned().empty()) {
+
+                owned = abandoned().back();
+
+                abandoned().pop_back();
+            }
+        }
+
+        if (!owned) {
+            owned = new heap();
+        }
+
+        current() = owned;
+    }
+
+    block_pool::thread_heap::~thread_heap() {
+        /*
+            Heaps are never deleted, since blocks of the heap
+            may still be held, and freed, by any thread.
+        */
+
+        exiting() = true;
+        current() = nullptr;
+
+        std::lock_guard<std::mutex> lock(shared_lock());
+
+        abandoned().push_back(owned);
+    }
+
+    /********************************************************************************************/
+    //
+    //                                  'region' Class Implementation
+    //
+    /********************************************************************************************/
+
+    region::region(std::pmr::memory_resource* upstream)
+        : _arena(block_pool::open_arena(upstream)), _outer(block_pool::current_arena()) {
+
+        block_pool::current_arena() = _arena;
+    }
+
+    region::~region() {
+
+        block_pool::current_arena() = _outer;
+
+        block_pool::close_arena(_arena);
+    }
+
+    std::size_t region::live() const {
+        return _arena->owned + _arena->shared.load(std::memory_order_acquire) - block_pool::open_bias;
+    }
+
+    std::pmr::memory_resource* region::upstream() const {
+        return _arena->upstream ? _arena->upstream : std::pmr::new_delete_resource();
+    }
+
+    void* region::do_allocate(std::size_t bytes, std::size_t align) {
+
+        if (!block_pool::pooled(bytes, align)) {
+            return upstream()->allocate(bytes, align);
+        }
+
+        return block_pool::bump(*_arena, bytes);
+    }
+
+    void region::do_deallocate(void* p, std::size_t bytes, std::size_t align) {
+
+        if (!block_pool::pooled(bytes, align)) {
+            upstream()->deallocate(p, bytes, align);
+            return;
+        }
+
+        block_pool::release(*_arena);
+    }
+
+    bool region::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+
+    /********************************************************************************************/
+    //
+    //                              'pool_allocator' Class Implementation
+    //
+    /********************************************************************************************/
+
+    template <typename T>
+    template <typename U>
+    pool_allocator<T>::pool_allocator(const pool_allocator<U>&) noexcept {
+    }
+
+    template <typename T>
+    T* pool_allocator<T>::allocate(std::size_t n) {
+
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+
+        return static_cast<T*>(block_pool::allocate(n * sizeof(T), alignof(T)));
+    }
+
+    template <typename T>
+    void pool_allocator<T>::deallocate(T* p, std::size_t n) noexcept {
+        block_pool::deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    template <typename T>
+    template <typename U>
+    bool pool_allocator<T>::operator==(const pool_allocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <typename T>
+    template <typename U>
+    bool pool_allocator<T>::operator!=(const pool_allocator<U>&) const noexcept {
+        return false;
+    }
+}
@@ -0,0 +1,334 @@
+#pragma once
+
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include "../../var.h"
+
+namespace Olly {
+
+    /********************************************************************************************/
+    //
+    //                                'reclaimer' Class Definition
+    //
+    //          Bounds the work of releasing a large structure.  The 'node' class releases
+    //          the cells following it in a loop rather than recursively, and asks the
+    //          'reclaimer' how many cells it may release before deferring the rest.
+    //
+    //          By default every cell is released in place.  A thread may choose to
+    //          release at most a number of cells in place by 'incremental', and later
+    //          release what it deferred in bounded increments by 'collect'.  Once a
+    //          background thread is started by 'start', every thread defers after the
+    //          number of cells given to it, unless the thread has chosen otherwise,
+    //          and the rest is released by the background thread.
+    //
+    //          Structures a thread deferred, and had not collected, are released in
+    //          place when the thread exits.  A background thread should be stopped
+    //          before the process exits, to release everything still queued to it.
+    //
+    /********************************************************************************************/
+
+    class reclaimer {
+
+    public:
+
+        static constexpr std::size_t unbounded    = std::numeric_limits<std::size_t>::max();
+        static constexpr std::size_t default_step = 256;
+
+        static std::size_t  step();                                   // The cells released in place, before deferring the rest.
+        static void         defer(var&& n);                           // Queue the rest of a structure to be released later.
+        static void         released(std::size_t cells);             // Count the cells released in place.
+
+        static void         incremental(std::size_t cells = default_step);   // Release at most 'cells' in place on the calling thread.
+        static void         immediate();                                     // Release every cell in place on the calling thread.
+
+        static std::size_t  collect(std::size_t cells);               // Release about 'cells' the calling thread deferred, returning the structures left.
+        static std::size_t  pending();                                // The structures deferred, and not yet released.
+
+        static void         start(std::size_t cells = default_step);  // Release deferred structures on a background thread.
+        static void         stop();                                   // Release everything queued, and stop the background thread.
+        static bool         running();
+
+    private:
+
+        struct local_queue {
+
+            ~local_queue();
+
+            std::vector<var> chains;
+        };
+
+        struct shared_queue {
+            std::mutex              lock;
+            std::condition_variable wake;
+            std::deque<var>         chains;
+            std::thread             worker;
+            bool                    running = false;
+        };
+
+        static void                      work();
+        static std::size_t&              thread_step();   // The step chosen by the thread, or zero for the shared step.
+        static std::size_t&              tally();         // The cells released in place by the thread.
+        static local_queue&              queue();
+        static shared_queue&             shared();
+        static std::atomic<std::size_t>& shared_step();
+        static std::atomic<bool>&        shared_running();
+    };
+
+    /********************************************************************************************/
+    //
+    //                                'reclaimer' Class Implementation
+    //
+    /********************************************************************************************/
+
+    std::size_t reclaimer::step() {
+
+        std::size_t cells = thread_step();
+
+        return cells ? cells : shared_step().load(std::memory_order_relaxed);
+    }
+
+    void reclaimer::defer(var&& n) {
+
+        if (shared_running().load(std::memory_order_acquire)) {
+
+            shared_queue& q = shared();
+
+            std::unique_lock<std::mutex> lock(q.lock);
+
+            if (q.running) {
+
+                q.chains.push_back(std::move(n));
+
+                lock.unlock();
+
+                q.wake.notify_one();
+
+                return;
+            }
+        }
+
+        queue().chains.push_back(std::move(n));
+    }
+
+    void reclaimer::released(std::size_t cells) {
+        tally() += cells;
+    }
+
+    void reclaimer::incremental(std::size_t cells) {
+        thread_step() = cells ? cells : 1;
+    }
+
+    void reclaimer::immediate() {
+        thread_step() = unbounded;
+    }
+
+    std::size_t reclaimer::collect(std::size_t cells) {
+        /*
+            Each structure is released with a step of the cells
+            left to release, so the remainder of it is deferred
+            again, onto the back of the queue.
+        */
+
+        std::vector<var>& chains = queue().chains;
+
+        const std::size_t chosen = thread_step();
+
+        tally() = 0;
+
+        while (tally() < cells && !chains.empty()) {
+
+            thread_step() = cells - tally();
+
+            var n = std::move(chains.back());
+
+            chains.pop_back();
+
+            n = var();
+
+            released(1);
+        }
+
+        thread_step() = chosen;
+
+        return chains.size();
+    }
+
+    std::size_t reclaimer::pending() {
+
+        std::size_t count = queue().chains.size();
+
+        shared_queue& q = shared();
+
+        std::lock_guard<std::mutex> lock(q.lock);
+
+        return count + q.chains.size();
+    }
+
+    void reclaimer::start(std::size_t cells) {
+
+        shared_queue& q = shared();
+
+        std::lock_guard<std::mutex> lock(q.lock);
+
+        if (q.running) {
+            return;
+        }
+
+        q.running = true;
+        q.worker  = std::thread(&reclaimer::work);
+
+        shared_step().store(cells ? cells : 1, std::memory_order_relaxed);
+        shared_running().store(true, std::memory_order_release);
+    }
+
+    void reclaimer::stop() {
+
+        shared_queue& q = shared();
+        {
+            std::lock_guard<std::mutex> lock(q.lock);
+
+            if (!q.running) {
+                return;
+            }
+
+            q.running = false;
+
+            shared_step().store(unbounded, std::memory_order_relaxed);
+            shared_running().store(false, std::memory_order_release);
+        }
+
+        q.wake.notify_one();
+
+        q.worker.join();
+    }
+
+    bool reclaimer::running() {
+        return shared_running().load(std::memory_order_acquire);
+    }
+
+    void reclaimer::work() {
+        /*
+            The background thread releases every cell in place,
+            and exits once stopped and the queue is empty.
+        */
+
+        immediate();
+
+        shared_queue& q = shared();
+
+        std::unique_lock<std::mutex> lock(q.lock);
+
+        while (true) {
+
+            q.wake.wait(lock, [&q]() { return !q.chains.empty() || !q.running; });
+
+            if (q.chains.empty()) {
+                return;
+            }
+
+            var n = std::move(q.chains.front());
+
+            q.chains.pop_front();
+
+            lock.unlock();
+
+            n = var();
+
+            lock.lock();
+        }
+    }
+
+    std::size_t& reclaimer::thread_step() {
+
+        thread_local std::size_t cells = 0;
+
+        return cells;
+    }
+
+    std::size_t& reclaimer::tally() {
+
+        thread_local std::size_t cells = 0;
+
+        return cells;
+    }
+
+    reclaimer::local_queue& reclaimer::queue() {
+
+        thread_local local_queue chains;
+
+        return chains;
+    }
+
+    reclaimer::shared_queue& reclaimer::shared() {
+
+        static auto* q = new shared_queue();
+
+        return *q;
+    }
+
+    std::atomic<std::size_t>& reclaimer::shared_step() {
+
+        static std::atomic<std::size_t> cells(unbounded);
+
+        return cells;
+    }
+
+    std::atomic<bool>& reclaimer::shared_running() {
+
+        static std::atomic<bool> flag(false);
+
+        return flag;
+    }
+
+    /********************************************************************************************/
+    //
+    //                          'reclaimer::local_queue' Class Implementation
+    //
+    /********************************************************************************************/
+
+    reclaimer::local_queue::~local_queue() {
+        /*
+            Release in place, so nothing is deferred to
+            the queue while it is destroyed.
+        */
+
+        immediate();
+
+        while (!chains.empty()) {
+
+            var n = std::move(chains.back());
+
+            chains.pop_back();
+        }
+    }
+}
@@ -0,0 +1,530 @@
+#pragma once
+
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include "base_type_definitions.h"
+
+namespace Olly {
+
+    /********************************************************************************************/
+    //
+    //                               Reference Count Policies
+    //
+    //          Every object boxed by a 'var' carries one of the reference counts below.
+    //          The policy is selected once per build, so that the whole library, and
+    //          not only the outer most 'var', counts references the same way.
+    //
+    //              atomic_ref_count  -  The default.  Safe to share between threads.
+    //              local_ref_count   -  Defining OLLY_SINGLE_THREADED selects plain
+    //                                   increments and decrements, for processes
+    //                                   which never share a 'var' between threads.
+    //              biased_ref_count  -  Defining OLLY_BIASED_REF_COUNT selects biased
+    //                                   reference counting, for values which are
+    //                                   mostly used by the thread creating them, but
+    //                                   are still shared between threads.
+    //
+    //          A policy constructs with a count of one, for the 'var' which boxes the
+    //          object.  'release' returns true once the last reference is released, and
+    //          the caller must then dispose of the object holding the count.  Objects
+    //          are disposed of by 'dispose', which deletes them unless an overload for
+    //          the type is found by argument dependent lookup.
+    //
+    /********************************************************************************************/
+
+    template <typename T>
+    void dispose(const T* object);
+
+    template <typename T>
+    void dispose(const T* object) {
+        delete object;
+    }
+
+    class atomic_ref_count {
+
+        mutable std::atomic<std::size_t> _count;
+
+    public:
+
+        atomic_ref_count();
+
+        void        retain()                        const;
+        template <typename T>
+        bool        release(const T* object)        const;
+        bool        unique()                        const;  // Is there only a single reference.
+    };
+
+    class local_ref_count {
+
+        mutable std::size_t _count;
+
+    public:
+
+        local_ref_count();
+
+        void        retain()                        const;
+        template <typename T>
+        bool        release(const T* object)        const;
+        bool        unique()                        const;
+    };
+
+    /********************************************************************************************/
+    //
+    //                               'biased_ref_count' Class Definition
+    //
+    //          Biased reference counting splits the count in two.  The thread which
+    //          created the object owns it, and counts its own references without any
+    //          atomic operations.  Every other thread counts on a shared atomic counter.
+    //          The shared count may drop below zero, when references made by the owner
+    //          are released by another thread.
+    //
+    //          The counts are merged once the owner releases its last reference.  If
+    //          the shared count drops below zero first, the object is queued to its
+    //          owner, which merges it the next time it constructs an object, calls
+    //          'merge_pending', or exits.  Objects of an owner which has already exited
+    //          are merged immediately by the releasing thread.
+    //
+    //          While queued, an object is only ever deleted by the merge.
+    //
+    /********************************************************************************************/
+
+    class biased_ref_count {
+
+        struct merge_request {
+            const biased_ref_count* count;
+            const void*             object;
+            void                  (*destroy)(const void*);
+        };
+
+        struct owner_queue {
+            std::vector<merge_request> requests;
+            std::atomic<bool>          pending;
+        };
+
+        class thread_owner;
+
+        static constexpr std::int64_t one    = 4;  // The shared count is stored above two flag bits.
+        static constexpr std::int64_t merged = 1;
+        static constexpr std::int64_t queued = 2;
+
+        mutable std::atomic<std::uint64_t> _owner;   // Zero once merged.
+        mutable std::size_t                _biased;
+        mutable std::atomic<std::int64_t>  _shared;
+
+    public:
+
+        biased_ref_count();
+
+        void        retain()                        const;
+        template <typename T>
+        bool        release(const T* object)        const;
+        bool        unique()                        const;
+
+        static void merge_pending();  // Merge every object queued to the calling thread.
+
+    private:
+
+        bool        is_owner()                      const;
+        void        enqueue(const merge_request& request) const;
+
+        static void merge(const merge_request& request);
+        static void merge_one(const merge_request& request);
+        template <typename T>
+        static void destroy(const void* object);
+
+        static std::uint64_t& current();   // The calling thread's owner id, or zero.
+        static bool&          exiting();
+        static owner_queue*&  queue();
+        static std::uint64_t  owner_id();  // Register the calling thread as an owner.
+
+        static std::mutex&    registry_lock();
+        static std::unordered_map<std::uint64_t, owner_queue*>& registry();
+    };
+
+    class biased_ref_count::thread_owner {
+
+        /********************************************************************************************/
+        //
+        //       Registers the queue of a thread owning objects, for the life of the thread.
+        //
+        /********************************************************************************************/
+
+    public:
+
+        thread_owner();
+        ~thread_owner();
+
+        std::uint64_t id;
+        owner_queue   requests;
+    };
+
+#if defined(OLLY_SINGLE_THREADED)
+    using ref_count = local_ref_count;
+#elif defined(OLLY_BIASED_REF_COUNT)
+    using ref_count = biased_ref_count;
+#else
+    using ref_count = atomic_ref_count;
+#endif
+
+    /********************************************************************************************/
+    //
+    //                            'atomic_ref_count' Class Implementation
+    //
+    /********************************************************************************************/
+
+    atomic_ref_count::atomic_ref_count() : _count(1) {
+    }
+
+    void atomic_ref_count::retain() const {
+        _count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    bool atomic_ref_count::release(const T* object) const {
+
+        if (_count.fetch_sub(1, std::memory_order_release) == 1) {
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool atomic_ref_count::unique() const {
+        return _count.load(std::memory_order_acquire) == 1;
+    }
+
+    /********************************************************************************************/
+    //
+    //                            'local_ref_count' Class Implementation
+    //
+    /********************************************************************************************/
+
+    local_ref_count::local_ref_count() : _count(1) {
+    }
+
+    void local_ref_count::retain() const {
+        _count += 1;
+    }
+
+    template <typename T>
+    bool local_ref_count::release(const T* object) const {
+        return --_count == 0;
+    }
+
+    bool local_ref_count::unique() const {
+        return _count == 1;
+    }
+
+    /********************************************************************************************/
+    //
+    //                            'biased_ref_count' Class Implementation
+    //
+    /********************************************************************************************/
+
+    biased_ref_count::biased_ref_count() : _owner(owner_id()), _biased(0), _shared(0) {
+
+        if (_owner.load(std::memory_order_relaxed)) {
+            _biased = 1;
+        }
+        else {
+            _shared.store(one | merged, std::memory_order_relaxed);
+        }
+    }
+
+    bool biased_ref_count::is_owner() const {
+
+        std::uint64_t owner = _owner.load(std::memory_order_relaxed);
+
+        return owner && owner == current();
+    }
+
+    void biased_ref_count::retain() const {
+
+        if (is_owner()) {
+            _biased += 1;
+        }
+        else {
+            _shared.fetch_add(one, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    bool biased_ref_count::release(const T* object) const {
+
+        if (is_owner()) {
+
+            if (--_biased) {
+                return false;
+            }
+
+            _owner.store(0, std::memory_order_release);
+
+            std::int64_t prev = _shared.fetch_or(merged, std::memory_order_acq_rel);
+
+            return !(prev & queued) && (prev >> 2) == 0;
+        }
+
+        std::int64_t prev  = _shared.fetch_sub(one, std::memory_order_acq_rel);
+        std::int64_t count = (prev >> 2) - 1;
+
+        if (prev & merged) {
+            return !(prev & queued) && count == 0;
+        }
+
+        if (count < 0 && !(prev & queued)) {
+
+            if (!(_shared.fetch_or(queued, std::memory_order_acq_rel) & queued)) {
+
+                enqueue({ this, object, &destroy<T> });
+            }
+        }
+
+        return false;
+    }
+
+    bool biased_ref_count::unique() const {
+
+        std::int64_t shared = _shared.load(std::memory_order_acquire);
+
+        if (is_owner()) {
+            return _biased == 1 && (shared >> 2) == 0;
+        }
+
+        return (shared & merged) && (shared >> 2) == 1;
+    }
+
+    void biased_ref_count::merge_pending() {
+
+        owner_queue* requests = queue();
+
+        if (!requests || !requests->pending.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        std::vector<merge_request> pending;
+        {
+            std::lock_guard<std::mutex> lock(registry_lock());
+
+            pending.swap(requests->requests);
+
+            requests->pending.store(false, std::memory_order_relaxed);
+        }
+
+        for (const auto& request : pending) {
+            merge(request);
+        }
+    }
+
+    void biased_ref_count::enqueue(const merge_request& request) const {
+        {
+            std::lock_guard<std::mutex> lock(registry_lock());
+
+            auto i = registry().find(_owner.load(std::memory_order_acquire));
+
+            if (i != registry().end()) {
+
+                i->second->requests.push_back(request);
+                i->second->pending.store(true, std::memory_order_release);
+
+                return;
+            }
+        }
+
+        merge(request);  // The owner has merged or exited.
+    }
+
+    void biased_ref_count::merge(const merge_request& request) {
+        /*
+            Destroying a merged object may release the last owned
+            reference to another, as a node releases the node after
+            it once its owner has exited.  Those are merged by the
+            outer most call in a loop, rather than recursively, so
+            a long list does not exhaust the stack.
+        */
+
+        thread_local std::vector<merge_request>* merging = nullptr;
+
+        if (merging) {
+
+            merging->push_back(request);
+
+            return;
+        }
+
+        std::vector<merge_request> pending{ request };
+
+        merging = &pending;
+
+        while (!pending.empty()) {
+
+            merge_request next = pending.back();
+
+            pending.pop_back();
+
+            merge_one(next);
+        }
+
+        merging = nullptr;
+    }
+
+    void biased_ref_count::merge_one(const merge_request& request) {
+
+        const biased_ref_count& count = *request.count;
+
+        std::int64_t biased = static_cast<std::int64_t>(count._biased);
+
+        count._biased = 0;
+        count._owner.store(0, std::memory_order_release);
+
+        std::int64_t prev = count._shared.load(std::memory_order_relaxed);
+        std::int64_t next;
+
+        do {
+            next = ((prev + biased * one) | merged) & ~queued;
+        } while (!count._shared.compare_exchange_weak(prev, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+        if ((next >> 2) == 0) {
+            request.destroy(request.object);
+        }
+    }
+
+    template <typename T>
+    void biased_ref_count::destroy(const void* object) {
+        dispose(static_cast<const T*>(object));
+    }
+
+    std::uint64_t& biased_ref_count::current() {
+
+        thread_local std::uint64_t id = 0;
+
+        return id;
+    }
+
+    bool& biased_ref_count::exiting() {
+
+        thread_local bool flag = false;
+
+        return flag;
+    }
+
+    biased_ref_count::owner_queue*& biased_ref_count::queue() {
+
+        thread_local owner_queue* requests = nullptr;
+
+        return requests;
+    }
+
+    std::uint64_t biased_ref_count::owner_id() {
+        /*
+            Objects constructed while the thread exits are never
+            owned, and count every reference on the shared count.
+        */
+
+        if (exiting()) {
+            return 0;
+        }
+
+        thread_local thread_owner owner;
+
+        merge_pending();
+
+        return owner.id;
+    }
+
+    std::mutex& biased_ref_count::registry_lock() {
+
+        static std::mutex* lock = new std::mutex();
+
+        return *lock;
+    }
+
+    std::unordered_map<std::uint64_t, biased_ref_count::owner_queue*>& biased_ref_count::registry() {
+
+        static auto* owners = new std::unordered_map<std::uint64_t, owner_queue*>();
+
+        return *owners;
+    }
+
+    /********************************************************************************************/
+    //
+    //                     'biased_ref_count::thread_owner' Class Implementation
+    //
+    /********************************************************************************************/
+
+    biased_ref_count::thread_owner::thread_owner() : id(0), requests() {
+
+        static std::atomic<std::uint64_t> next_id(1);
+
+        id = next_id.fetch_add(1, std::memory_order_relaxed);
+
+        requests.pending.store(false, std::memory_order_relaxed);
+
+        {
+            std::lock_guard<std::mutex> lock(registry_lock());
+
+            registry()[id] = &requests;
+        }
+
+        current() = id;
+        queue()   = &requests;
+    }
+
+    biased_ref_count::thread_owner::~thread_owner() {
+        /*
+            Once unregistered the thread counts on the shared count
+            of its objects, so their biased counts are left fixed for
+            any thread merging them later.
+        */
+
+        std::vector<merge_request> pending;
+
+        exiting() = true;
+
+        {
+            std::lock_guard<std::mutex> lock(registry_lock());
+
+            registry().erase(id);
+
+            current() = 0;
+            queue()   = nullptr;
+
+            pending.swap(requests.requests);
+        }
+
+        for (const auto& request : pending) {
+            merge(request);
+        }
+    }
+}
@@ -0,0 +1,563 @@
+#pragma once
+
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+
+#include "base_type_definitions.h"
+
+#include <cerrno>
+
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Olly {
+
+    /********************************************************************************************/
+    //
+    //                                'text_writer' Class Definition
+    //
+    //          The 'text_writer' class is the stream every string conversion writes
+    //          to.  It appends into a growable buffer, which keeps its capacity when
+    //          cleared, and converts numbers with 'std::to_chars'.  So once the buffer
+    //          has grown to fit, writing text never allocates.
+    //
+    //          Doubles are printed with six significant digits by default, matching
+    //          'std::ostream'.  The 'boolalpha', 'noboolalpha', 'dec', 'hex' and 'oct'
+    //          manipulators are honored, other types are written through their
+    //          'std::ostream' insertion operator.
+    //
+    //          A 'writer_lease' borrows a cleared writer from a pool kept per thread,
+    //          and returns it when destroyed.  Leases may nest, so a conversion may
+    //          call 'str' or 'repr' while it is writing.
+    //
+    //          A writer given a 'text_sink' streams instead.  Whenever its buffer
+    //          reaches the chunk size the text is handed to the sink and the buffer is
+    //          cleared, so the memory used never depends upon the length of the text.
+    //          A sink writes to a 'std::ostream', a file descriptor, or a callback
+    //          taking a 'std::string_view'.
+    //
+    /********************************************************************************************/
+
+    class text_sink {
+
+    public:
+
+        text_sink();
+
+        template <typename F>
+        static text_sink     callback(F& f);                    // Call 'f(std::string_view)' with each chunk.
+        static text_sink       stream(std::ostream& stream);    // Write each chunk to a stream.
+        static text_sink   descriptor(int fd);                  // Write each chunk to a file descriptor.
+
+        void               operator()(const char* data, std::size_t size) const;
+        explicit        operator bool()                                   const;
+
+    private:
+
+        using write_function = void (*)(void* context, const char* data, std::size_t size);
+
+        text_sink(write_function write, void* context);
+
+        write_function  _write;
+        void*           _context;
+    };
+
+    class text_writer {
+
+    public:
+
+        static constexpr std::size_t default_chunk_size = 1 << 14;
+
+        text_writer();
+        explicit text_writer(std::size_t capacity);
+        explicit text_writer(text_sink sink, std::size_t chunk_size = default_chunk_size);
+        ~text_writer();
+
+        text_writer(const text_writer&)            = delete;
+        text_writer& operator=(const text_writer&) = delete;
+
+        text_writer&            put(char c);                               // Append a character.
+        text_writer&          write(const char* data, std::size_t size);  // Append a sequence of characters.
+        text_writer&          write(std::string_view text);              // Append a string.
+
+        text_writer&     operator<<(char x);
+        text_writer&     operator<<(signed char x);
+        text_writer&     operator<<(unsigned char x);
+        text_writer&     operator<<(const char* x);
+        text_writer&     operator<<(std::string_view x);
+        text_writer&     operator<<(const Text& x);
+        text_writer&     operator<<(bool x);
+        text_writer&     operator<<(std::ios_base& (*manip)(std::ios_base&));
+
+        template <typename T>
+        std::enable_if_t<std::is_integral_v<T>, text_writer&>
+                         operator<<(T x);
+
+        template <typename T>
+        std::enable_if_t<std::is_floating_point_v<T>, text_writer&>
+                         operator<<(T x);
+
+        template <typename T>
+        std::enable_if_t<!std::is_arithmetic_v<T> && !std::is_array_v<T> && is_streamable<std::ostream, const T&>::value, text_writer&>
+                         operator<<(const T& x);
+
+        std::string_view       view()                       const;  // The text written.
+        Text                    str()                       const;  // A copy of the text written.
+        const char*            data()                       const;
+        std::size_t            size()                       const;
+        bool                  empty()                       const;
+
+        void                  clear();                              // Discard the text, keeping the buffer.
+        void                  flush();                              // Hand any text buffered to the sink.
+        bool              streaming()                       const;  // Is the text handed to a sink.
+        bool        standard_format()                       const;  // Is the format that of 'str' and 'repr'.
+        void                reserve(std::size_t capacity);
+        std::size_t        capacity()                       const;
+
+        bool              boolalpha()                       const;
+        void              boolalpha(bool flag);                     // Print bools as 'true' and 'false'.
+        int                    base()                       const;
+        void                   base(int base);                      // The base of integers, 10, 16 or 8.
+        int               precision()                       const;
+        void              precision(int digits);                    // Significant digits of floating points.
+
+    private:
+
+        Text         _buffer;
+        text_sink    _sink;
+        std::size_t  _chunk_size;   // The size at which the buffer is flushed, never without a sink.
+        bool         _boolalpha;
+        int          _base;
+        int          _precision;
+    };
+
+    class writer_lease {
+
+    public:
+
+        writer_lease();
+        ~writer_lease();
+
+        writer_lease(const writer_lease&)            = delete;
+        writer_lease& operator=(const writer_lease&) = delete;
+
+        text_writer&     operator*()                        const;
+        text_writer*    operator->()                        const;
+
+        static constexpr std::size_t max_pooled_capacity = 1 << 16;  // Larger buffers are freed, not pooled.
+
+    private:
+
+        std::unique_ptr<text_writer> _writer;
+
+        static std::vector<std::unique_ptr<text_writer>>& pool();
+    };
+
+    /********************************************************************************************/
+    //
+    //                               'text_sink' Class Implementation
+    //
+    /********************************************************************************************/
+
+    text_sink::text_sink() : _write(nullptr), _context(nullptr) {
+    }
+
+    text_sink::text_sink(write_function write, void* context) : _write(write), _context(context) {
+    }
+
+    template <typename F>
+    text_sink text_sink::callback(F& f) {
+
+        return text_sink([](void* context, const char* data, std::size_t size) {
+            (*static_cast<F*>(context))(std::string_view(data, size));
+        }, &f);
+    }
+
+    text_sink text_sink::stream(std::ostream& stream) {
+
+        return text_sink([](void* context, const char* data, std::size_t size) {
+            static_cast<std::ostream*>(context)->write(data, static_cast<std::streamsize>(size));
+        }, &stream);
+    }
+
+    text_sink text_sink::descriptor(int fd) {
+        /*
+            The descriptor is carried in the context pointer
+            itself.  Partial writes are resumed, and writing
+            stops at the first error.
+        */
+
+        return text_sink([](void* context, const char* data, std::size_t size) {
+
+            const int fd = static_cast<int>(reinterpret_cast<std::intptr_t>(context));
+
+            while (size) {
+#ifdef _MSC_VER
+                const auto count = ::_write(fd, data, static_cast<unsigned int>(size < 0x40000000 ? size : 0x40000000));
+#else
+                const auto count = ::write(fd, data, size);
+#endif
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+
+                if (count <= 0) {
+                    return;
+                }
+
+                data += count;
+                size -= static_cast<std::size_t>(count);
+            }
+        }, reinterpret_cast<void*>(static_cast<std::intptr_t>(fd)));
+    }
+
+    void text_sink::operator()(const char* data, std::size_t size) const {
+        _write(_context, data, size);
+    }
+
+    text_sink::operator bool() const {
+        return _write != nullptr;
+    }
+
+    /********************************************************************************************/
+    //
+    //                              'text_writer' Class Implementation
+    //
+    /********************************************************************************************/
+
+    text_writer::text_writer()
+        : _buffer(), _sink(), _chunk_size(std::numeric_limits<std::size_t>::max()),
+          _boolalpha(false), _base(10), _precision(6) {
+    }
+
+    text_writer::text_writer(std::size_t capacity) : text_writer() {
+        _buffer.reserve(capacity);
+    }
+
+    text_writer::text_writer(text_sink sink, std::size_t chunk_size) : text_writer() {
+
+        if (sink) {
+            _sink       = sink;
+            _chunk_size = chunk_size ? chunk_size : 1;
+
+            _buffer.reserve(_chunk_size);
+        }
+    }
+
+    text_writer::~text_writer() {
+        flush();
+    }
+
+    text_writer& text_writer::put(char c) {
+
+        _buffer.push_back(c);
+
+        if (_buffer.size() >= _chunk_size) {
+            flush();
+        }
+
+        return *this;
+    }
+
+    text_writer& text_writer::write(const char* data, std::size_t size) {
+        /*
+            Without a sink the chunk size is never reached.
+            With one, text at least a chunk long is handed
+            over directly, rather than grow the buffer.
+        */
+
+        if (_buffer.size() + size >= _chunk_size) {
+
+            flush();
+
+            if (size >= _chunk_size) {
+
+                _sink(data, size);
+
+                return *this;
+            }
+        }
+
+        _buffer.append(data, size);
+
+        return *this;
+    }
+
+    text_writer& text_writer::write(std::string_view text) {
+        return write(text.data(), text.size());
+    }
+
+    text_writer& text_writer::operator<<(char x) {
+        return put(x);
+    }
+
+    text_writer& text_writer::operator<<(signed char x) {
+        return put(static_cast<char>(x));
+    }
+
+    text_writer& text_writer::operator<<(unsigned char x) {
+        return put(static_cast<char>(x));
+    }
+
+    text_writer& text_writer::operator<<(const char* x) {
+        return write(std::string_view(x));
+    }
+
+    text_writer& text_writer::operator<<(std::string_view x) {
+        return write(x);
+    }
+
+    text_writer& text_writer::operator<<(const Text& x) {
+        return write(x.data(), x.size());
+    }
+
+    text_writer& text_writer::operator<<(bool x) {
+
+        if (_boolalpha) {
+            return x ? write("true", 4) : write("false", 5);
+        }
+
+        return put(x ? '1' : '0');
+    }
+
+    text_writer& text_writer::operator<<(std::ios_base& (*manip)(std::ios_base&)) {
+        /*
+            Only the manipulators the writer understands
+            are applied, any others are ignored.
+        */
+
+        if (manip == std::boolalpha) {
+            _boolalpha = true;
+        }
+        else if (manip == std::noboolalpha) {
+            _boolalpha = false;
+        }
+        else if (manip == std::dec) {
+            _base = 10;
+        }
+        else if (manip == std::hex) {
+            _base = 16;
+        }
+        else if (manip == std::oct) {
+            _base = 8;
+        }
+
+        return *this;
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_integral_v<T>, text_writer&>
+    text_writer::operator<<(T x) {
+
+        /*
+            Widen first, so character types are
+            printed as numbers like any other.
+        */
+
+        using wide = std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>;
+
+        char digits[24];
+
+        auto result = std::to_chars(digits, digits + sizeof(digits), static_cast<wide>(x), _base);
+
+        return write(digits, static_cast<std::size_t>(result.ptr - digits));
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_floating_point_v<T>, text_writer&>
+    text_writer::operator<<(T x) {
+        /*
+            The precision is clamped, so the sign, digits,
+            point and exponent always fit the buffer.
+        */
+
+        char digits[64];
+
+        int precision = _precision < 0 ? 6 : (_precision > 40 ? 40 : _precision);
+
+        auto result = std::to_chars(digits, digits + sizeof(digits), x, std::chars_format::general, precision);
+
+        return write(digits, static_cast<std::size_t>(result.ptr - digits));
+    }
+
+    template <typename T>
+    std::enable_if_t<!std::is_arithmetic_v<T> && !std::is_array_v<T> && is_streamable<std::ostream, const T&>::value, text_writer&>
+    text_writer::operator<<(const T& x) {
+        /*
+            Types without a native conversion are written
+            through a stream reused by the thread.
+        */
+
+        thread_local std::ostringstream stream;
+
+        stream.str(Text());
+        stream.clear();
+        stream.flags(_boolalpha ? std::ios_base::boolalpha : std::ios_base::fmtflags());
+        stream.precision(_precision);
+
+        stream << x;
+
+        return write(stream.view());
+    }
+
+    std::string_view text_writer::view() const {
+        return std::string_view(_buffer);
+    }
+
+    Text text_writer::str() const {
+        return _buffer;
+    }
+
+    const char* text_writer::data() const {
+        return _buffer.data();
+    }
+
+    std::size_t text_writer::size() const {
+        return _buffer.size();
+    }
+
+    bool text_writer::empty() const {
+        return _buffer.empty();
+    }
+
+    void text_writer::clear() {
+
+        _buffer.clear();
+
+        _boolalpha = false;
+        _base      = 10;
+        _precision = 6;
+    }
+
+    void text_writer::flush() {
+
+        if (_sink && !_buffer.empty()) {
+
+            _sink(_buffer.data(), _buffer.size());
+
+            _buffer.clear();
+        }
+    }
+
+    bool text_writer::streaming() const {
+        return static_cast<bool>(_sink);
+    }
+
+    bool text_writer::standard_format() const {
+        return _boolalpha && _base == 10 && _precision == 6;
+    }
+
+    void text_writer::reserve(std::size_t capacity) {
+        _buffer.reserve(capacity);
+    }
+
+    std::size_t text_writer::capacity() const {
+        return _buffer.capacity();
+    }
+
+    bool text_writer::boolalpha() const {
+        return _boolalpha;
+    }
+
+    void text_writer::boolalpha(bool flag) {
+        _boolalpha = flag;
+    }
+
+    int text_writer::base() const {
+        return _base;
+    }
+
+    void text_writer::base(int base) {
+        _base = (base == 16 || base == 8) ? base : 10;
+    }
+
+    int text_writer::precision() const {
+        return _precision;
+    }
+
+    void text_writer::precision(int digits) {
+        _precision = digits;
+    }
+
+    /********************************************************************************************/
+    //
+    //                              'writer_lease' Class Implementation
+    //
+    /********************************************************************************************/
+
+    writer_lease::writer_lease() : _writer() {
+
+        auto& writers = pool();
+
+        if (writers.empty()) {
+            _writer = std::make_unique<text_writer>();
+        }
+        else {
+            _writer = std::move(writers.back());
+            writers.pop_back();
+        }
+    }
+
+    writer_lease::~writer_lease() {
+        /*
+            Keep the buffer for the next lease, unless an
+            unusually large conversion grew it.
+        */
+
+        if (_writer->capacity() > max_pooled_capacity) {
+            return;
+        }
+
+        _writer->clear();
+
+        pool().push_back(std::move(_writer));
+    }
+
+    text_writer& writer_lease::operator*() const {
+        return *_writer;
+    }
+
+    text_writer* writer_lease::operator->() const {
+        return _writer.get();
+    }
+
+    std::vector<std::unique_ptr<text_writer>>& writer_lease::pool() {
+
+        thread_local std::vector<std::unique_ptr<text_writer>> writers;
+
+        return writers;
+    }
+}
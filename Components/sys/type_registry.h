@@ -0,0 +1,121 @@
+#pragma once
+
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+
+#include "base_type_definitions.h"
+
+namespace Olly {
+
+    /********************************************************************************************/
+    //
+    //                                'type_registry' Class Definition
+    //
+    //          Assigns each type held by a 'var' a dense integer id, the first time the
+    //          type is registered.  Ids begin at zero and are never reused, so they may
+    //          index tables sized by 'size()'.  Checking the id of a type already
+    //          registered never allocates.
+    //
+    //          Type and category names are interned, so every name is stored once and
+    //          equal names share the same instance.  Interned names may therefore be
+    //          compared by address.
+    //
+    /********************************************************************************************/
+
+    class type_registry {
+
+    public:
+
+        template <typename T>
+        static std::size_t           id();                      // The id of the type, registering it if needed.
+        static std::size_t         size();                      // The number of types registered.
+
+        static const Text&       intern(const Text& name);     // The shared instance of a name.
+
+    private:
+
+        static std::atomic<std::size_t>&      next_id();
+        static std::mutex&                names_mutex();
+        static std::unordered_set<Text>&         names();
+    };
+
+    /********************************************************************************************/
+    //
+    //                              'type_registry' Class Implementation
+    //
+    /********************************************************************************************/
+
+    template <typename T>
+    std::size_t type_registry::id() {
+
+        static const std::size_t id = next_id().fetch_add(1, std::memory_order_relaxed);
+
+        return id;
+    }
+
+    std::size_t type_registry::size() {
+        return next_id().load(std::memory_order_relaxed);
+    }
+
+    const Text& type_registry::intern(const Text& name) {
+        /*
+            Elements of an unordered set are never moved
+            by a rehash, so a reference to one is stable.
+        */
+
+        std::lock_guard<std::mutex> lock(names_mutex());
+
+        return *names().insert(name).first;
+    }
+
+    std::atomic<std::size_t>& type_registry::next_id() {
+
+        static std::atomic<std::size_t> count(0);
+
+        return count;
+    }
+
+    std::mutex& type_registry::names_mutex() {
+
+        static std::mutex mutex;
+
+        return mutex;
+    }
+
+    std::unordered_set<Text>& type_registry::names() {
+
+        static std::unordered_set<Text> set;
+
+        return set;
+    }
+}
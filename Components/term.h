@@ -43,6 +43,11 @@ namespace Olly {
     //          The term class is implemented using Lisp inspired data nodes.  It
     //          is used to define the data sets as in Lisp.  
     //
+    //          A term built from a range joins a cell for each element directly,
+    //          last element first, rather than copying the term for every element.
+    //          Prepending a range is linear in the length of the range, and
+    //          appending one in the length of both, as the cells are rebuilt.
+    //
     /********************************************************************************************/
 
     class term {
@@ -50,14 +55,29 @@ namespace Olly {
         var         _term;
         std::size_t _size;
 
+        template <typename I, typename S>
+        void prepend(I first, S last);
+
     public:
 
         term();
         term(var x);
+        template <typename R>
+        term(from_range_t, R&& range);
+        template <typename I, typename S>
+            requires std::input_iterator<I> && std::sentinel_for<S, I>
+        term(I first, S last);
+
+        template <typename R> void   append_range(R&& range);  // Add the elements of 'range' after the last.
+        template <typename R> void  prepend_range(R&& range);  // Add the elements of 'range' before the first.
+
+        template <typename F> void           each(F&& f)   const;  // Call 'f' with each element, in order.
+        template <typename F> void  each_reversed(F&& f)   const;  // Call 'f' with each element, last first.
 
         friend Text           _type_(const term& self);
         friend bool             _is_(const term& self);
         friend double         _comp_(const term& self, const var& other);
+        friend bool         _equals_(const term& self, const var& other);
 
         friend void            _str_(Text_Stream& out, const term& self);
         friend void           _repr_(Text_Stream& out, const term& self);
@@ -65,8 +85,12 @@ namespace Olly {
         friend std::size_t    _size_(const term& self);
         friend var            _lead_(const term& self);
         friend var            _join_(const term& self, const var& other);
+        friend var            _join_(const term& self, var&& other);
+        friend void           _join_(term& self, var&& other);
         friend var            _next_(const term& self);
+        friend void           _next_(term& self);
         friend var         _reverse_(const term& self);
+        friend std::size_t    _hash_(const term& self);
     };
 
     /********************************************************************************************/
@@ -78,7 +102,98 @@ namespace Olly {
     term::term() : _term(node()), _size(0) {
     }
 
-    term::term(var x) : _term(node(x)), _size(_term.size()) {
+    term::term(var x) : _term(node(std::move(x))), _size(_term.size()) {
+    }
+
+    template <typename R>
+    term::term(from_range_t, R&& range) : term() {
+
+        prepend(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    template <typename I, typename S>
+        requires std::input_iterator<I> && std::sentinel_for<S, I>
+    term::term(I first, S last) : term() {
+
+        prepend(std::move(first), std::move(last));
+    }
+
+    template <typename I, typename S>
+    void term::prepend(I first, S last) {
+        /*
+            The cells are joined last element first, so a range
+            which can only be walked forward is copied before.
+        */
+
+        if constexpr (std::bidirectional_iterator<I> && std::same_as<I, S>) {
+
+            while (last != first) {
+
+                var x(*--last);
+
+                if (x.is_nothing()) {
+                    continue;
+                }
+
+                _term = node(std::move(x), std::move(_term));
+                _size += 1;
+            }
+        }
+        else {
+
+            std::vector<var> elements;
+
+            for (; first != last; ++first) {
+                elements.emplace_back(*first);
+            }
+
+            prepend(elements.begin(), elements.end());
+        }
+    }
+
+    template <typename R>
+    void term::append_range(R&& range) {
+
+        term a;
+
+        a.prepend(std::ranges::begin(range), std::ranges::end(range));
+
+        if (!a._size) {
+            return;
+        }
+
+        each_reversed([&](const var& x) {
+            a._term = node(x, std::move(a._term));
+            a._size += 1;
+        });
+
+        *this = std::move(a);
+    }
+
+    template <typename R>
+    void term::prepend_range(R&& range) {
+
+        prepend(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    template <typename F>
+    void term::each(F&& f) const {
+
+        auto cells = _term.cast<node>();
+
+        if (cells) {
+            cells->each(std::forward<F>(f));
+        }
+    }
+
+    template <typename F>
+    void term::each_reversed(F&& f) const {
+
+        auto cells = _term.cast<node>();
+
+        if (cells) {
+            cells->each_reversed(std::forward<F>(f));
+        }
     }
 
     std::string _type_(const term& self) {
@@ -104,6 +219,21 @@ namespace Olly {
         return NOT_A_NUMBER;
     }
 
+    bool _equals_(const term& self, const var& other) {
+
+        auto ptr = other.cast<term>();
+
+        if (ptr) {
+            /*
+                Terms of differing sizes are never walked.
+            */
+
+            return self._size == ptr->_size && self._term.equals(ptr->_term);
+        }
+
+        return false;
+    }
+
     void _str_(Text_Stream& out, const term& self) {
 
         out << "(";
@@ -111,7 +241,6 @@ namespace Olly {
         if (self._term.is()) {
 
             self._term.str(out);
-            out.seekp(-1, out.cur);
         }
 
         out << ")";
@@ -124,7 +253,6 @@ namespace Olly {
         if (self._term.is()) {
 
             self._term.repr(out);
-            out.seekp(-1, out.cur);
         }
 
         out << ")";
@@ -139,6 +267,10 @@ namespace Olly {
     }
 
     var _join_(const term& self, const var& other) {
+        return _join_(self, var(other));
+    }
+
+    var _join_(const term& self, var&& other) {
 
         if (other.is_nothing()) {
             return self;
@@ -146,12 +278,22 @@ namespace Olly {
 
         term a{ self };
 
-        a._term = a._term.join(other);
+        a._term = a._term.join(std::move(other));
         a._size += 1;
 
         return a;
     }
 
+    void _join_(term& self, var&& other) {
+
+        if (other.is_nothing()) {
+            return;
+        }
+
+        self._term = std::move(self._term).join(std::move(other));
+        self._size += 1;
+    }
+
     var _next_(const term& self) {
 
         if (!_is_(self)) {
@@ -166,6 +308,16 @@ namespace Olly {
         return a;
     }
 
+    void _next_(term& self) {
+
+        if (!_is_(self)) {
+            return;
+        }
+
+        self._term = std::move(self._term).next();
+        self._size -= 1;
+    }
+
     var _reverse_(const term& self) {
 
         if (self._term.is_nothing()) {
@@ -179,4 +331,8 @@ namespace Olly {
 
         return a;
     }
+
+    std::size_t _hash_(const term& self) {
+        return self._term.hash();
+    }
 }
\ No newline at end of file
@@ -3,4 +3,6 @@
 #include "var.h"
 #include "Components/node.h"
 #include "Components/term.h"
-#include "Components/expression.h"
\ No newline at end of file
+#include "Components/stream.h"
+#include "Components/expression.h"
+#include "Components/sequence.h"
\ No newline at end of file
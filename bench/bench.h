@@ -0,0 +1,116 @@
+#pragma once
+
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "../Oliver.h"
+
+namespace Olly::bench {
+
+    /********************************************************************************************/
+    //
+    //                                 Benchmark Helpers
+    //
+    //          Each driver in this directory is a single translation unit, built on
+    //          its own with optimizations.  The helpers time a block of work, or the
+    //          latency of each operation, and print the result in the same format.
+    //
+    /********************************************************************************************/
+
+    using clock = std::chrono::steady_clock;
+
+    inline double elapsed_ns(clock::time_point from, clock::time_point to) {
+        return std::chrono::duration<double, std::nano>(to - from).count();
+    }
+
+    template <typename F>
+    double time_ms(F&& f) {
+
+        auto from = clock::now();
+
+        f();
+
+        return elapsed_ns(from, clock::now()) / 1e6;
+    }
+
+    template <typename F>
+    double best_ms(std::size_t runs, F&& f) {
+
+        double best = time_ms(f);
+
+        for (std::size_t i = 1; i < runs; ++i) {
+            best = std::min(best, time_ms(f));
+        }
+
+        return best;
+    }
+
+    class latency {
+
+        std::vector<double> _samples;
+
+    public:
+
+        template <typename F>
+        void measure(F&& f) {
+
+            auto from = clock::now();
+
+            f();
+
+            _samples.push_back(elapsed_ns(from, clock::now()));
+        }
+
+        void report(const char* name) {
+
+            if (_samples.empty()) {
+                return;
+            }
+
+            std::sort(_samples.begin(), _samples.end());
+
+            auto at = [&](double q) {
+                return _samples[std::min(_samples.size() - 1, static_cast<std::size_t>(q * _samples.size()))];
+            };
+
+            std::printf("%-36s n=%8zu  p50 %8.0f ns  p99 %8.0f ns  max %11.0f ns\n",
+                        name, _samples.size(), at(0.50), at(0.99), _samples.back());
+
+            _samples.clear();
+        }
+    };
+}
@@ -0,0 +1,128 @@
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include <thread>
+
+#include "bench.h"
+
+/********************************************************************************************/
+//
+//                                  Biased Reference Count
+//
+//          Walks a node of a million elements by 'next', retaining and releasing
+//          each node it passes.  First the thread which built it walks it alone,
+//          then every thread walks it at once, and last another thread releases
+//          it.  Build it with and without OLLY_BIASED_REF_COUNT, and compare.
+//
+/********************************************************************************************/
+
+#if defined(OLLY_SINGLE_THREADED)
+#error "The list is shared between threads, which OLLY_SINGLE_THREADED does not allow."
+#endif
+
+using namespace Olly;
+
+static const std::size_t elements = 1000000;
+static const std::size_t walks    = 10;
+static const std::size_t runs     = 3;
+
+static std::size_t walk(const var& list) {
+
+    std::size_t count = 0;
+
+    for (std::size_t i = 0; i < walks; ++i) {
+
+        var a = list;
+
+        while (a.is()) {
+            a = a.next();
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+static var build() {
+
+    var list = node();
+
+    for (std::size_t i = 0; i < elements; ++i) {
+        list = list.join(var(i));
+    }
+
+    return list;
+}
+
+int main() {
+
+#if defined(OLLY_BIASED_REF_COUNT)
+    const char* policy = "biased_ref_count";
+#else
+    const char* policy = "atomic_ref_count";
+#endif
+
+    const std::size_t threads = std::max<std::size_t>(2, std::thread::hardware_concurrency());
+
+    var list = build();
+
+    std::size_t total = 0;
+
+    double owner = bench::best_ms(runs, [&]() {
+        total += walk(list);
+    });
+
+    double shared = bench::best_ms(runs, [&]() {
+
+        std::vector<std::thread> walkers;
+
+        for (std::size_t i = 0; i < threads; ++i) {
+            walkers.emplace_back([&list]() { walk(list); });
+        }
+
+        for (auto& t : walkers) {
+            t.join();
+        }
+    });
+
+    double handed = bench::best_ms(runs, [&]() {
+
+        var other = build();
+
+        std::thread([&other]() { other = var(); }).join();
+    });
+
+    std::printf("%-18s owner walks %8.1f ms, %zu threads walk %8.1f ms, build and release on another thread %8.1f ms  (%zu)\n",
+                policy, owner, threads, shared, handed, total);
+
+    return 0;
+}
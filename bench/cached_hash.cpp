@@ -0,0 +1,97 @@
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include <unordered_set>
+
+#include "bench.h"
+
+/********************************************************************************************/
+//
+//                                     Cached Hashes
+//
+//          Looks up nested expressions in an unordered set, each of 2000 elements
+//          held in 20 inner expressions.  Each lookup hashes the key, and compares
+//          it with the keys of the same bucket.  Build it with and without
+//          OLLY_CACHED_HASH, and compare.
+//
+/********************************************************************************************/
+
+using namespace Olly;
+
+static const std::size_t keys    = 200;
+static const std::size_t inner   = 20;
+static const std::size_t each    = 100;
+static const std::size_t lookups = 10000;
+
+int main() {
+
+#if defined(OLLY_CACHED_HASH)
+    const char* build = "OLLY_CACHED_HASH";
+#else
+    const char* build = "uncached";
+#endif
+
+    std::vector<var> v;
+
+    for (std::size_t k = 0; k < keys; ++k) {
+
+        var outer = expression();
+
+        for (std::size_t i = 0; i < inner; ++i) {
+
+            var x = expression();
+
+            for (std::size_t j = 0; j < each; ++j) {
+                x = x.link(var(k * inner * each + i * each + j));
+            }
+
+            outer = outer.link(x);
+        }
+
+        v.push_back(outer);
+    }
+
+    std::unordered_set<var> set(v.begin(), v.end());
+
+    std::size_t found = 0;
+
+    double ms = bench::time_ms([&]() {
+        for (std::size_t i = 0; i < lookups; ++i) {
+            found += set.count(v[i % keys]);
+        }
+    });
+
+    std::printf("%-16s %zu lookups of %zu keys of %zu elements: %10.3f us per lookup  (%zu found)\n",
+                build, lookups, keys, inner * each, ms * 1e3 / lookups, found);
+
+    return 0;
+}
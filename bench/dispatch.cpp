@@ -0,0 +1,97 @@
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include "bench.h"
+
+/********************************************************************************************/
+//
+//                                       Dispatch
+//
+//          Calls a few operations on each 'var' of a vector mixing numbers, text,
+//          nodes, expressions and nothing, and reports the time of each call.  The
+//          types are shuffled, so the calls cannot be predicted from the last.
+//
+/********************************************************************************************/
+
+using namespace Olly;
+
+static const std::size_t values = 4096;
+static const std::size_t passes = 2000;
+static const std::size_t runs   = 5;
+
+template <typename F>
+static void report(const char* name, const std::vector<var>& v, F&& f) {
+
+    std::size_t sink = 0;
+
+    double ms = bench::best_ms(runs, [&]() {
+        for (std::size_t i = 0; i < passes; ++i) {
+            for (const var& x : v) {
+                sink += f(x);
+            }
+        }
+    });
+
+    std::printf("%-10s %6.2f ns  (%zu)\n", name, ms * 1e6 / (passes * v.size()), sink);
+}
+
+int main() {
+
+    std::vector<var> v;
+
+    std::uint64_t state = 0x9E3779B97F4A7C15ULL;  // A fixed xorshift sequence, so every revision dispatches the same.
+
+    for (std::size_t i = 0; i < values; ++i) {
+
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        switch (state % 6) {
+            case 0:  v.emplace_back(static_cast<int>(i));                break;
+            case 1:  v.emplace_back(static_cast<double>(i) / 3);         break;
+            case 2:  v.emplace_back(std::string("text"));                break;
+            case 3:  v.emplace_back(var(node()).join(var(i)));           break;
+            case 4:  v.emplace_back(var(expression()).link(var(i)));     break;
+            default: v.emplace_back();                                   break;
+        }
+    }
+
+    const var key(0);
+
+    report("size()",    v, [](const var& x) { return x.size(); });
+    report("is()",      v, [](const var& x) { return static_cast<std::size_t>(x.is()); });
+    report("op_code()", v, [](const var& x) { return static_cast<std::size_t>(x.op_code()); });
+    report("get()",     v, [&](const var& x) { return static_cast<std::size_t>(x.get(key).is_something()); });
+
+    return 0;
+}
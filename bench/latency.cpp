@@ -0,0 +1,160 @@
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include "bench.h"
+
+/********************************************************************************************/
+//
+//                                  Expression Latency
+//
+//          Reports the median, 99th percentile and worst latency of each operation
+//          on an expression of a million elements.  Each is run first with the
+//          default reclaimer, which releases every unshared cell in place, and then
+//          with 'reclaimer::incremental', collecting after each operation, so the
+//          cells released per operation are bounded as well.  The first line of
+//          each reports timing nothing, the floor the others are measured against.
+//
+/********************************************************************************************/
+
+using namespace Olly;
+
+static const std::size_t elements = 1000000;
+static const std::size_t versions = 2000;
+
+static void run(const char* mode, std::size_t step) {
+
+    bench::latency l;
+
+    auto collect = [&]() {
+        if (step) {
+            reclaimer::collect(step);
+        }
+    };
+
+    std::printf("-- %s\n", mode);
+
+    for (std::size_t i = 0; i < elements; ++i) {
+        l.measure([&]() {});
+    }
+
+    l.report("nothing, the noise of the timer");
+
+    var e = expression();
+
+    for (std::size_t i = 0; i < elements; ++i) {
+        l.measure([&]() { e = e.link(var(i)); collect(); });
+    }
+
+    l.report("link");
+
+    var full = e;
+
+    for (std::size_t i = 0; i < elements; ++i) {
+        l.measure([&]() { e = e.next(); collect(); });
+    }
+
+    l.report("next");
+
+    e = full;
+
+    for (std::size_t i = 0; i < elements; ++i) {
+        l.measure([&]() { e = e.prev(); collect(); });
+    }
+
+    l.report("prev");
+
+    e = expression();
+
+    for (std::size_t i = 0; i < elements; ++i) {
+        l.measure([&]() { e = e.join(var(i)); collect(); });
+    }
+
+    l.report("join");
+
+    e = expression();
+
+    for (std::size_t i = 0; i < elements; ++i) {
+        l.measure([&]() {
+            e = (i & 1) ? e.link(var(i)) : e.join(var(i));
+
+            if (i % 3 == 2) {
+                e = e.prev();
+            }
+
+            collect();
+        });
+    }
+
+    l.report("mixed join, link and prev");
+
+    /*
+        Removing an element from the same version again and
+        again must not repeat a rotation each time.
+    */
+
+    var shared = full.next();
+
+    for (std::size_t i = 0; i < versions; ++i) {
+        l.measure([&]() { var x = shared.prev(); collect(); });
+    }
+
+    l.report("prev of one shared version");
+
+    for (std::size_t i = 0; i < versions; ++i) {
+        l.measure([&]() { var x = shared.next(); collect(); });
+    }
+
+    l.report("next of one shared version");
+
+    full = var();
+    e    = var();
+
+    l.measure([&]() { shared = var(); collect(); });
+
+    l.report("drop the last version");
+
+    while (reclaimer::collect(reclaimer::default_step)) {
+    }
+}
+
+int main() {
+
+    run("default reclaimer", 0);
+
+    reclaimer::incremental(64);
+
+    run("reclaimer::incremental(64)", 64);
+
+    reclaimer::immediate();
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "bench.h"
+
+/********************************************************************************************/
+//
+//                                   Nothing Allocations
+//
+//          Counts the allocations made while constructing, copying, returning and
+//          destroying the nothing 'var', and while calling the default '_op_'
+//          functions on it, which should be none.  Every allocation made by the
+//          process passes through the replaced global 'operator new' below.  Each
+//          is run once before it is counted.
+//
+/********************************************************************************************/
+
+/*
+    Every form of the global 'operator new' and 'operator delete'
+    is replaced, so that each allocation is counted and freed by
+    its own kind.  They are kept out of line, so the compiler does
+    not pair the 'malloc' and 'free' within them with the 'new' and
+    'delete' of the callers it inlines them into.
+*/
+
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+static std::atomic<std::size_t> allocations{ 0 };
+
+static void* allocate(std::size_t size) noexcept {
+
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    return std::malloc(size ? size : 1);
+}
+
+static void* allocate(std::size_t size, std::align_val_t align) noexcept {
+    /*
+        The block is over allocated, and the address 'malloc'
+        returned is kept in the word before the aligned block.
+    */
+
+    const std::size_t alignment = std::max(static_cast<std::size_t>(align), sizeof(void*));
+
+    void* raw = allocate(size + alignment + sizeof(void*));
+
+    if (!raw) {
+        return nullptr;
+    }
+
+    std::uintptr_t block = (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + alignment - 1) & ~(alignment - 1);
+
+    reinterpret_cast<void**>(block)[-1] = raw;
+
+    return reinterpret_cast<void*>(block);
+}
+
+static void release(void* p) noexcept {
+    std::free(p);
+}
+
+static void release(void* p, std::align_val_t) noexcept {
+    if (p) {
+        std::free(static_cast<void**>(p)[-1]);
+    }
+}
+
+template <typename... Args>
+static void* allocate_or_throw(Args... args) {
+
+    if (void* p = allocate(args...)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+BENCH_NOINLINE void* operator new(std::size_t size)                                                  { return allocate_or_throw(size); }
+BENCH_NOINLINE void* operator new[](std::size_t size)                                                { return allocate_or_throw(size); }
+BENCH_NOINLINE void* operator new(std::size_t size, const std::nothrow_t&) noexcept                  { return allocate(size); }
+BENCH_NOINLINE void* operator new[](std::size_t size, const std::nothrow_t&) noexcept                { return allocate(size); }
+BENCH_NOINLINE void* operator new(std::size_t size, std::align_val_t align)                          { return allocate_or_throw(size, align); }
+BENCH_NOINLINE void* operator new[](std::size_t size, std::align_val_t align)                        { return allocate_or_throw(size, align); }
+BENCH_NOINLINE void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept   { return allocate(size, align); }
+BENCH_NOINLINE void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return allocate(size, align); }
+
+BENCH_NOINLINE void operator delete(void* p) noexcept                                                { release(p); }
+BENCH_NOINLINE void operator delete[](void* p) noexcept                                              { release(p); }
+BENCH_NOINLINE void operator delete(void* p, std::size_t) noexcept                                   { release(p); }
+BENCH_NOINLINE void operator delete[](void* p, std::size_t) noexcept                                 { release(p); }
+BENCH_NOINLINE void operator delete(void* p, const std::nothrow_t&) noexcept                         { release(p); }
+BENCH_NOINLINE void operator delete[](void* p, const std::nothrow_t&) noexcept                       { release(p); }
+BENCH_NOINLINE void operator delete(void* p, std::align_val_t align) noexcept                        { release(p, align); }
+BENCH_NOINLINE void operator delete[](void* p, std::align_val_t align) noexcept                      { release(p, align); }
+BENCH_NOINLINE void operator delete(void* p, std::size_t, std::align_val_t align) noexcept           { release(p, align); }
+BENCH_NOINLINE void operator delete[](void* p, std::size_t, std::align_val_t align) noexcept         { release(p, align); }
+BENCH_NOINLINE void operator delete(void* p, std::align_val_t align, const std::nothrow_t&) noexcept   { release(p, align); }
+BENCH_NOINLINE void operator delete[](void* p, std::align_val_t align, const std::nothrow_t&) noexcept { release(p, align); }
+
+using namespace Olly;
+
+static const std::size_t iterations = 1000000;
+
+static var returned() {
+    return var();
+}
+
+template <typename F>
+static void count(const char* name, F&& f) {
+    /*
+        Run once first, so that anything a function builds on
+        its first call, such as a static, is not counted.
+    */
+
+    f();
+
+    const std::size_t before = allocations.load(std::memory_order_relaxed);
+
+    double ms = bench::time_ms([&]() {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            f();
+        }
+    });
+
+    const std::size_t made = allocations.load(std::memory_order_relaxed) - before;
+
+    std::printf("%-24s %10zu allocations  %6.2f ns\n", name, made, ms * 1e6 / iterations);
+}
+
+int main() {
+
+    var a;
+    var b;
+
+    std::size_t sink = 0;  // Results which are not a 'var', so they are not boxed.
+
+    count("construct and destroy", [&]() { var x; b = x; });
+    count("copy",                  [&]() { var x = a; b = x; });
+    count("return",                [&]() { b = returned(); });
+    count("is",                    [&]() { sink += a.is(); });
+    count("size",                  [&]() { sink += a.size(); });
+    count("lead",                  [&]() { b = a.lead(); });
+    count("last",                  [&]() { b = a.last(); });
+    count("next",                  [&]() { b = a.next(); });
+    count("prev",                  [&]() { b = a.prev(); });
+    count("get",                   [&]() { b = a.get(b); });
+    count("hash",                  [&]() { sink += a.hash(); });
+    count("equals",                [&]() { sink += a.equals(b); });
+
+    std::printf("(%zu)\n", sink);
+
+    return 0;
+}
@@ -0,0 +1,86 @@
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include <limits>
+
+#include "bench.h"
+
+/********************************************************************************************/
+//
+//                                     Block Pool
+//
+//          Builds a node of ten million strings, and then releases it, timing the
+//          two apart.  Build it with and without OLLY_DEFAULT_ALLOCATOR, and compare.
+//          The first run warms the pool, and the best of the rest is reported.
+//
+/********************************************************************************************/
+
+using namespace Olly;
+
+static const std::size_t elements = 10000000;
+static const std::size_t runs     = 3;
+
+int main() {
+
+#if defined(OLLY_DEFAULT_ALLOCATOR)
+    const char* allocator = "new and delete";
+#else
+    const char* allocator = "block_pool";
+#endif
+
+    double built    = std::numeric_limits<double>::max();
+    double released = std::numeric_limits<double>::max();
+
+    for (std::size_t r = 0; r <= runs; ++r) {
+
+        var list = node();
+
+        double b = bench::time_ms([&]() {
+            for (std::size_t i = 0; i < elements; ++i) {
+                list = list.join(var(std::string("x")));
+            }
+        });
+
+        double d = bench::time_ms([&]() {
+            list = var();
+        });
+
+        if (r) {
+            built    = std::min(built, b);
+            released = std::min(released, d);
+        }
+    }
+
+    std::printf("%-16s %zu strings: build %8.1f ms, release %8.1f ms\n", allocator, elements, built, released);
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+/*************************************************************************************/
+//
+//			                    Copyright 2022 Max J. Martin
+//
+//			                    This file is part of Oliver.
+//
+//      Boost Software License - Version 1.0 - August 17th, 2003
+//
+//      Permission is hereby granted, free of charge, to any person or organization
+//      obtaining a copy of the software and accompanying documentation covered by
+//      this license(the "Software") to use, reproduce, display, distribute,
+//      execute, and transmit the Software, and to prepare derivative works of the
+//      Software, and to permit third - parties to whom the Software is furnished to
+//      do so, all subject to the following :
+//
+//      The copyright notices in the Software and this entire statement, including
+//      the above license grant, this restriction and the following disclaimer,
+//      must be included in all copies of the Software, in whole or in part, and
+//      all derivative works of the Software, unless such copies or derivative
+//      works are solely in the form of machine - executable object code generated by
+//      a source language processor.
+//
+//      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//      FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON - INFRINGEMENT.IN NO EVENT
+//      SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+//      FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+//      ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+//      DEALINGS IN THE SOFTWARE.
+//			
+/*************************************************************************************/
+
+#include "bench.h"
+
+/********************************************************************************************/
+//
+//                               Reference Count Policies
+//
+//          Walks a node of a million elements, once by 'size' and once by 'next',
+//          which retains and releases each node it passes.  Build it once for each
+//          policy, and compare the times.
+//
+//              default                   -  atomic_ref_count
+//              -DOLLY_SINGLE_THREADED    -  local_ref_count
+//              -DOLLY_BIASED_REF_COUNT   -  biased_ref_count
+//
+/********************************************************************************************/
+
+using namespace Olly;
+
+static const std::size_t elements = 1000000;
+static const std::size_t walks    = 20;
+static const std::size_t runs     = 5;
+
+int main() {
+
+#if defined(OLLY_SINGLE_THREADED)
+    const char* policy = "local_ref_count";
+#elif defined(OLLY_BIASED_REF_COUNT)
+    const char* policy = "biased_ref_count";
+#else
+    const char* policy = "atomic_ref_count";
+#endif
+
+    var list = node();
+
+    for (std::size_t i = 0; i < elements; ++i) {
+        list = list.join(var(i));
+    }
+
+    std::size_t total = 0;
+
+    double sized = bench::best_ms(runs, [&]() {
+        for (std::size_t i = 0; i < walks; ++i) {
+            total += list.size();
+        }
+    });
+
+    double walked = bench::best_ms(runs, [&]() {
+        for (std::size_t i = 0; i < walks; ++i) {
+
+            var a = list;
+
+            while (a.is()) {
+                a = a.next();
+                ++total;
+            }
+        }
+    });
+
+    std::printf("%-18s %zu walks of %zu nodes: size() %8.1f ms, next() %8.1f ms  (%zu)\n",
+                policy, walks, elements, sized, walked, total);
+
+    return 0;
+}
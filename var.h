@@ -33,7 +33,13 @@
 /*************************************************************************************/
 
 #include "Components/sys/base_type_definitions.h"
+#include "Components/sys/hash.h"
+#include "Components/sys/instrumentation.h"
 #include "Components/sys/OP_CODES.h"
+#include "Components/sys/pool_allocator.h"
+#include "Components/sys/ref_count.h"
+#include "Components/sys/text_writer.h"
+#include "Components/sys/type_registry.h"
 
 namespace Olly {
 
@@ -57,7 +63,7 @@ namespace Olly {
     //
     //          The 'var' class also supports both pass by reference and pass by value.
     //          Any object it holds can be safely cast to a pointer of the object type.
-    //          If the type cast is made to an incorrect data type then a std::nothing_ptr
+    //          If the type cast is made to an incorrect data type then a null 'var_ptr'
     //          is returned instead.
     // 
     //          All object can also be copied to ann instance of the type safely.  If
@@ -77,6 +83,40 @@ namespace Olly {
 
     const enum class OP_CODE;
 
+    class nothing;
+    class var_ref;
+
+    template <typename T>           // The types a 'var' holds as immediate values.
+    constexpr bool is_immediate_type = std::is_same_v<T, bool> || std::is_same_v<T, int>
+                                    || std::is_same_v<T, long> || std::is_same_v<T, double>
+                                    || std::is_same_v<T, nothing>;
+
+    template <typename T, bool Immediate = is_immediate_type<T>>
+    class var_ptr;
+
+    /********************************************************************************************/
+    //
+    //                                'capability' Enumeration
+    //
+    //          Names each '_op_' function a type may override.  A 'var' reports the
+    //          functions overridden by the type it holds as a bit mask, so callers can
+    //          test for an operation without dispatching it.
+    //
+    /********************************************************************************************/
+
+    enum class capability : std::uint64_t {
+        type, cat, is, str, repr, comp, equals,
+        b_and, b_or, b_xor, b_neg, u_add, u_neg,
+        add, sub, mul, div, mod, f_div, rem, pow, root,
+        has, size, lead, last, join, link, next, prev, drop, take, reverse,
+        get, set, del,
+        hash, help, is_nothing, op_code
+    };
+
+    constexpr std::uint64_t capability_bit(capability op) {   // The bit of an operation within a capability mask.
+        return std::uint64_t(1) << static_cast<std::uint64_t>(op);
+    }
+
     class var {
         struct interface_type;
 
@@ -84,99 +124,138 @@ namespace Olly {
 
         var();
         template <typename T>          var(T  x);
+        var(const var& n);
+        var(var&& n) noexcept;
+        var(const var_ref& n);
+        ~var();
+
+        var& operator=(const var& n);
+        var& operator=(var&& n) noexcept;
 
-        friend std::ostream& operator<<(std::ostream& stream, var n);
+        friend std::ostream& operator<<(std::ostream& stream, const var& n);
+        friend Text_Stream&  operator<<(Text_Stream& out, const var& n);
 
-        template <typename T> std::shared_ptr<const T>  cast()       const;  // Cast the object as an instance of the specified type.
+        template <typename T>               var_ptr<T>  cast()       const;  // Cast the object as an instance of the specified type.
         template <typename T>                        T  copy()       const;  // Get a copy of the objects as a specified type.
 
-        Text              type()                    const;  // The class generated type name.
-        Text               cat()                    const;  // The class generated category name.
-        bool                is()                    const;  // Is or is not the object defined.
-        void               str(Text_Stream& out)    const;  // String representation of the object.
-        void              repr(Text_Stream& out)    const;  // Recreatable text representation of an object.
-
-        operator bool()                             const;
-
-        double            comp(var n)               const;  // Compare two objects. 0 = equality, > 0 = grater than, < 0 = less than, NAN = not same type.
-        bool                eq(var n)               const;  // Equal to.
-        bool                ne(var n)               const;  // Not equal to.
-        bool                ge(var n)               const;  // Greater than equal to.
-        bool                le(var n)               const;  // Less than equal to.
-        bool                gt(var n)               const;  // Greater than.
-        bool                lt(var n)               const;  // Less than.
-
-        bool    operator==(var n)                   const;
-        bool    operator!=(var n)                   const;
-        bool    operator>=(var n)                   const;
-        bool    operator> (var n)                   const;
-        bool    operator<=(var n)                   const;
-        bool    operator< (var n)                   const;
-
-        var              b_and(var n)               const;  // Binary and.
-        var               b_or(var n)               const;  // Binary or.
-        var              b_xor(var n)               const;  // Binary exclusive or.
-        var              b_neg()                    const;  // Binary negation.
-
-        var         operator&(var n)                const;
-        var         operator|(var n)                const;
-        var         operator^(var n)                const;
-        var         operator~()                     const;
-
-        var              u_add()                    const;  // Addition identity.
-        var              u_neg()                    const;  // Unary compliment.
-
-        var                add(var n)               const;  // Addition.
-        var                sub(var n)               const;  // Subtraction.
-        var                mul(var n)               const;  // Multiplication.
-        var                div(var n)               const;  // Division.
-        var                mod(var n)               const;  // Modulus.
-
-        var          operator+()                    const;
-        var          operator-()                    const;
-
-        var          operator+(var n)               const;
-        var          operator-(var n)               const;
-        var          operator*(var n)               const;
-        var          operator/(var n)               const;
-        var          operator%(var n)               const;
-
-        var              f_div(var n)               const;  // Floor divide.
-        var                rem(var n)               const;  // Remainder.
-        var                pow(var n)               const;  // Raise to the power of.
-        var               root(var n)               const;  // Reduce to the root of.
-
-        bool               has(var n)               const;  // Determine if an object has an element.
-        std::size_t       size()                    const;  // Size of an object.
-        var               lead()                    const;  // Lead element of an object.
-        var               last()                    const;  // Last element of an object.
-        var               join(var n)               const;  // Place an object as the lead element.
-        var               link(var n)               const;  // Place an object as the lead element.
-        var               next()                    const;  // Remove the lead element from an object.
-        var               prev()                    const;  // Remove the lead element from an object.
-
-        var         operator>>(std::size_t shift)   const;
-        var         operator<<(std::size_t shift)   const;
-
-        var          operator,(var n)               const;
-
-        var                get(var key)             const;  // Get an element from a collection.
-        var                set(var key, var val)    const;  // Set the value of an element in a collection.
-        var                del(var key)             const;  // Delete an element from a collection.
-
-        var            reverse()                    const;  // Reverse the order of an object's elements.
-
-        std::size_t       hash()                    const;  // Get the hash of an object.
-        OP_CODE        op_code()                    const;
-        bool        is_nothing()                    const;
-        bool      is_something()                    const;
-        Text              help()                    const;  // Define a string description of the object.
+        template <typename... Ts, typename F>
+        decltype(auto)                     visit(F&& f)              const;  // Call 'f' with the object as the first matching type of 'Ts', else with the 'var'.
+
+        const Text&       type()                               const;  // The class generated type name, interned once per type.
+        const Text&        cat()                               const;  // The class generated category name, interned once per type.
+        std::size_t    type_id()                               const;  // The registered id of the type held.
+        std::uint64_t capabilities()                           const;  // Bit mask of the '_op_' functions overridden by the type held.
+        bool              supports(capability op)              const;  // Does the type held override the operation.
+
+        template <typename T, capability op>
+        static constexpr bool has_override();                          // Does the type override the operation, known at compile time.
+
+        template <typename T>
+        bool                is()                               const;  // Does the 'var' hold the specified type.
+        bool                is()                               const;  // Is or is not the object defined.
+        void               str(Text_Stream& out)               const;  // String representation of the object.
+        void              repr(Text_Stream& out)               const;  // Recreatable text representation of an object.
+
+        operator bool()                                        const;
+
+        double            comp(const var& n)                   const;  // Compare two objects. 0 = equality, > 0 = grater than, < 0 = less than, NAN = not same type.
+        bool            equals(const var& n)                   const;  // Equality, without ordering the objects.
+        std::partial_ordering compare(const var& n)            const;  // Three way comparison, unordered when not comparable.
+        bool                eq(const var& n)                   const;  // Equal to.
+        bool                ne(const var& n)                   const;  // Not equal to.
+        bool                ge(const var& n)                   const;  // Greater than equal to.
+        bool                le(const var& n)                   const;  // Less than equal to.
+        bool                gt(const var& n)                   const;  // Greater than.
+        bool                lt(const var& n)                   const;  // Less than.
+
+        bool    operator==(const var& n)                       const;
+        bool    operator!=(const var& n)                       const;
+        bool    operator>=(const var& n)                       const;
+        bool    operator> (const var& n)                       const;
+        bool    operator<=(const var& n)                       const;
+        bool    operator< (const var& n)                       const;
+
+        var              b_and(const var& n)                   const;  // Binary and.
+        var               b_or(const var& n)                   const;  // Binary or.
+        var              b_xor(const var& n)                   const;  // Binary exclusive or.
+        var              b_neg()                               const;  // Binary negation.
+
+        var         operator&(const var& n)                    const;
+        var         operator|(const var& n)                    const;
+        var         operator^(const var& n)                    const;
+        var         operator~()                                const;
+
+        var              u_add()                               const;  // Addition identity.
+        var              u_neg()                               const;  // Unary compliment.
+
+        var                add(const var& n)                   const;  // Addition.
+        var                sub(const var& n)                   const;  // Subtraction.
+        var                mul(const var& n)                   const;  // Multiplication.
+        var                div(const var& n)                   const;  // Division.
+        var                mod(const var& n)                   const;  // Modulus.
+
+        var          operator+()                               const;
+        var          operator-()                               const;
+
+        var          operator+(const var& n)                   const;
+        var          operator-(const var& n)                   const;
+        var          operator*(const var& n)                   const;
+        var          operator/(const var& n)                   const;
+        var          operator%(const var& n)                   const;
+
+        var              f_div(const var& n)                   const;  // Floor divide.
+        var                rem(const var& n)                   const;  // Remainder.
+        var                pow(const var& n)                   const;  // Raise to the power of.
+        var               root(const var& n)                   const;  // Reduce to the root of.
+
+        bool               has(const var& n)                   const;  // Determine if an object has an element.
+        std::size_t       size()                               const;  // Size of an object.
+        var               lead()                               const;  // Lead element of an object.
+        var               last()                               const;  // Last element of an object.
+        var               join(const var& n)                   const&; // Place an object as the lead element.
+        var               join(var&& n)                        const&;
+        var               join(const var& n)                   &&;     // As above, changing the object in place if only this 'var' references it.
+        var               join(var&& n)                        &&;
+        var               link(const var& n)                   const&; // Place an object as the lead element.
+        var               link(var&& n)                        const&;
+        var               link(const var& n)                   &&;
+        var               link(var&& n)                        &&;
+        var               next()                               const&; // Remove the lead element from an object.
+        var               next()                               &&;
+        var               prev()                               const&; // Remove the lead element from an object.
+        var               prev()                               &&;
+        var               drop(std::size_t n)                  const;  // Remove the first 'n' elements from an object.
+        var               take(std::size_t n)                  const;  // Keep only the first 'n' elements of an object.
+
+        var         operator>>(std::size_t shift)              const;
+        var         operator<<(std::size_t shift)              const;
+
+        var          operator,(const var& n)                   const&;
+        var          operator,(var&& n)                        const&;
+        var          operator,(const var& n)                   &&;
+        var          operator,(var&& n)                        &&;
+
+        var                get(const var& key)                 const;  // Get an element from a collection.
+        var                set(const var& key, const var& val) const;  // Set the value of an element in a collection.
+        var                set(const var& key, var&& val)      const;
+        var                del(const var& key)                 const;  // Delete an element from a collection.
+
+        var            reverse()                               const;  // Reverse the order of an object's elements.
+
+        std::size_t       hash()                               const;  // Get the hash of an object.
+        OP_CODE        op_code()                               const;
+        bool        is_nothing()                               const;
+        bool      is_something()                               const;
+        bool            unique()                               const;  // Is the 'var' the only reference to the object it holds.
+        Text              help()                               const;  // Define a string description of the object.
 
         // TODO: add capture of arguments to pass to a function.
         // TODO: figure out how to incorporate expression iteration.
 
     private:
 
+        struct operations;
+
         struct interface_type {
 
             /********************************************************************************************/
@@ -184,59 +263,224 @@ namespace Olly {
             //                              'interface_type' Class Definition
             //
             //       A simple interface description allowing redirection of the 'var' data type.
+            //       Each call is made through the static table of 'operations' of the type
+            //       held, rather than through virtual functions.  It carries its own reference
+            //       count, which is shared by every 'var' referencing the instance.  See
+            //       'ref_count.h' for the policies.
             //
             /********************************************************************************************/
 
-            virtual ~interface_type() {};
-
-            virtual operator bool()                           const = 0;
-
-            virtual Text            _type()                   const = 0;
-            virtual Text            _cat()                    const = 0;
-            virtual bool            _is()                     const = 0;
-            virtual void            _str(Text_Stream& out)    const = 0;
-            virtual void            _repr(Text_Stream& out)   const = 0;
-
-            virtual double          _comp(var n)              const = 0;
-
-            virtual var             _b_and(var n)             const = 0;
-            virtual var             _b_or(var n)              const = 0;
-            virtual var             _b_xor(var n)             const = 0;
-            virtual var             _b_neg()                  const = 0;
-
-            virtual var             _u_add()                  const = 0;
-            virtual var             _u_neg()                  const = 0;
+            interface_type(std::size_t type_id, const operations* ops) : _type_id(type_id), _ops(ops) {};
+
+            ref_count         _count;
+            std::size_t       _type_id;   // The registered id of the type held by the 'data_type'.
+            const operations* _ops;       // The operations of the type held by the 'data_type'.
+
+#if defined(OLLY_CACHED_TEXT)
+            mutable std::atomic<const Text*> _str_text{ nullptr };    // The 'str' of the object, once cached.
+            mutable std::atomic<const Text*> _repr_text{ nullptr };   // The 'repr' of the object, once cached.
+
+            void _free_text()                                     const;
+            void _reset_text()                                    const;  // Forget the text of an object changed in place.
+
+            void _write_cached(std::atomic<const Text*>& text, Text_Stream& out, std::size_t max_size,
+                               void (*render)(const interface_type* p, Text_Stream& out)) const;
+#endif
+
+            operator bool()                                       const;
+
+            const Text&     _type()                               const;
+            const Text&     _cat()                                const;
+            bool            _is()                                 const;
+            void            _str(Text_Stream& out)                const;
+            void            _repr(Text_Stream& out)               const;
+
+            double          _comp(const var& n)                   const;
+            bool            _equals(const var& n)                 const;
+
+            var             _b_and(const var& n)                  const;
+            var             _b_or(const var& n)                   const;
+            var             _b_xor(const var& n)                  const;
+            var             _b_neg()                              const;
+
+            var             _u_add()                              const;
+            var             _u_neg()                              const;
+
+            var             _add(const var& n)                    const;
+            var             _sub(const var& n)                    const;
+            var             _mul(const var& n)                    const;
+            var             _div(const var& n)                    const;
+            var             _mod(const var& n)                    const;
+
+            var             _f_div(const var& n)                  const;
+            var             _rem(const var& n)                    const;
+            var             _pow(const var& n)                    const;
+            var             _root(const var& n)                   const;
+
+            bool            _has(const var& n)                    const;
+            std::size_t     _size()                               const;
+            var             _lead()                               const;
+            var             _last()                               const;
+            var             _join(const var& n)                   const;
+            var             _join(var&& n)                        const;
+            var             _link(const var& n)                   const;
+            var             _link(var&& n)                        const;
+            var             _next()                               const;
+            var             _prev()                               const;
+            var             _drop(std::size_t n)                  const;
+            var             _take(std::size_t n)                  const;
+
+            var             _reverse()                            const;
+
+            var             _get(const var& key)                  const;
+            var             _set(const var& key, const var& val)  const;
+            var             _set(const var& key, var&& val)       const;
+            var             _del(const var& key)                  const;
+
+            std::size_t     _hash()                               const;
+            Text            _help()                               const;
+            bool            _is_nothing()                         const;
+            OP_CODE         _op_code()                            const;
+        };
 
-            virtual var             _add(var n)               const = 0;
-            virtual var             _sub(var n)               const = 0;
-            virtual var             _mul(var n)               const = 0;
-            virtual var             _div(var n)               const = 0;
-            virtual var             _mod(var n)               const = 0;
+        struct operations {
 
-            virtual var             _f_div(var n)             const = 0;
-            virtual var             _rem(var n)               const = 0;
-            virtual var             _pow(var n)               const = 0;
-            virtual var             _root(var n)              const = 0;
+            /********************************************************************************************/
+            //
+            //                                'operations' Table Definition
+            //
+            //       One table is built at compile time for each type held by a 'var'.  Every
+            //       operation a type does not override points to a single shared default,
+            //       rather than to a copy of the default made for each type.
+            //
+            /********************************************************************************************/
 
-            virtual bool            _has(var n)               const = 0;
-            virtual std::size_t     _size()                   const = 0;
-            virtual var             _lead()                   const = 0;
-            virtual var             _last()                   const = 0;
-            virtual var             _join(var n)              const = 0;
-            virtual var             _link(var n)              const = 0;
-            virtual var             _next()                   const = 0;
-            virtual var             _prev()                   const = 0;
+            std::uint64_t capabilities;   // Bit mask of the '_op_' functions overridden by the type.
+
+            void          (*destroy)(const interface_type* p);
+
+            const Text&   (*type)(const interface_type* p);
+            const Text&   (*cat)(const interface_type* p);
+            bool          (*is)(const interface_type* p);
+            void          (*str)(const interface_type* p, Text_Stream& out);
+            void          (*repr)(const interface_type* p, Text_Stream& out);
+
+            double        (*comp)(const interface_type* p, const var& n);
+            bool          (*equals)(const interface_type* p, const var& n);
+
+            var           (*b_and)(const interface_type* p, const var& n);
+            var           (*b_or)(const interface_type* p, const var& n);
+            var           (*b_xor)(const interface_type* p, const var& n);
+            var           (*b_neg)(const interface_type* p);
+
+            var           (*u_add)(const interface_type* p);
+            var           (*u_neg)(const interface_type* p);
+
+            var           (*add)(const interface_type* p, const var& n);
+            var           (*sub)(const interface_type* p, const var& n);
+            var           (*mul)(const interface_type* p, const var& n);
+            var           (*div)(const interface_type* p, const var& n);
+            var           (*mod)(const interface_type* p, const var& n);
+
+            var           (*f_div)(const interface_type* p, const var& n);
+            var           (*rem)(const interface_type* p, const var& n);
+            var           (*pow)(const interface_type* p, const var& n);
+            var           (*root)(const interface_type* p, const var& n);
+
+            bool          (*has)(const interface_type* p, const var& n);
+            std::size_t   (*size)(const interface_type* p);
+            var           (*lead)(const interface_type* p);
+            var           (*last)(const interface_type* p);
+            var           (*join)(const interface_type* p, const var& n);
+            var           (*join_move)(const interface_type* p, var&& n);
+            var           (*link)(const interface_type* p, const var& n);
+            var           (*link_move)(const interface_type* p, var&& n);
+            var           (*next)(const interface_type* p);
+            var           (*prev)(const interface_type* p);
+            var           (*drop)(const interface_type* p, std::size_t n);
+            var           (*take)(const interface_type* p, std::size_t n);
+
+            void          (*join_in_place)(interface_type* p, var&& n);   // Null unless the type changes itself in place.
+            void          (*link_in_place)(interface_type* p, var&& n);
+            void          (*next_in_place)(interface_type* p);
+            void          (*prev_in_place)(interface_type* p);
+
+            var           (*reverse)(const interface_type* p);
+
+            var           (*get)(const interface_type* p, const var& key);
+            var           (*set)(const interface_type* p, const var& key, const var& val);
+            var           (*set_move)(const interface_type* p, const var& key, var&& val);
+            var           (*del)(const interface_type* p, const var& key);
+
+            std::size_t   (*hash)(const interface_type* p);
+            Text          (*help)(const interface_type* p);
+            bool          (*is_nothing)(const interface_type* p);
+            OP_CODE       (*op_code)(const interface_type* p);
+        };
 
-            virtual var             _reverse()                const = 0;
+        struct default_type {
 
-            virtual var             _get(var key)             const = 0;
-            virtual var             _set(var key, var val)    const = 0;
-            virtual var             _del(var key)             const = 0;
+            /******************************************************************************************/
+            //
+            //                                'default_type' Class Definition
+            //
+            //             The shared default operations.  Each calls the default '_op_'
+            //             function, none of which depend upon the type they are called on.
+            //             The defaults which do depend on the type, such as '_type_' and
+            //             '_str_', are always called through the 'data_type' itself.
+            //
+            /******************************************************************************************/
 
-            virtual std::size_t     _hash()                   const = 0;
-            virtual Text            _help()                   const = 0;
-            virtual bool            _is_nothing()             const = 0;
-            virtual OP_CODE         _op_code()                const = 0;
+            static constexpr operations table();   // The operations of a type overriding nothing.
+
+            static const Text&   cat(const interface_type* p);
+            static bool          is(const interface_type* p);
+            static void          repr(const interface_type* p, Text_Stream& out);
+
+            static double        comp(const interface_type* p, const var& n);
+            static bool          equals(const interface_type* p, const var& n);
+
+            static var           b_and(const interface_type* p, const var& n);
+            static var           b_or(const interface_type* p, const var& n);
+            static var           b_xor(const interface_type* p, const var& n);
+
+            static var           u_add(const interface_type* p);
+            static var           u_neg(const interface_type* p);
+
+            static var           add(const interface_type* p, const var& n);
+            static var           sub(const interface_type* p, const var& n);
+            static var           mul(const interface_type* p, const var& n);
+            static var           div(const interface_type* p, const var& n);
+            static var           mod(const interface_type* p, const var& n);
+
+            static var           f_div(const interface_type* p, const var& n);
+            static var           rem(const interface_type* p, const var& n);
+            static var           pow(const interface_type* p, const var& n);
+            static var           root(const interface_type* p, const var& n);
+
+            static bool          has(const interface_type* p, const var& n);
+            static std::size_t   size(const interface_type* p);
+            static var           lead(const interface_type* p);
+            static var           last(const interface_type* p);
+            static var           join(const interface_type* p, const var& n);
+            static var           join_move(const interface_type* p, var&& n);
+            static var           link(const interface_type* p, const var& n);
+            static var           link_move(const interface_type* p, var&& n);
+            static var           next(const interface_type* p);
+            static var           prev(const interface_type* p);
+            static var           drop(const interface_type* p, std::size_t n);
+            static var           take(const interface_type* p, std::size_t n);
+
+            static var           reverse(const interface_type* p);
+
+            static var           get(const interface_type* p, const var& key);
+            static var           set(const interface_type* p, const var& key, const var& val);
+            static var           set_move(const interface_type* p, const var& key, var&& val);
+            static var           del(const interface_type* p, const var& key);
+
+            static Text          help(const interface_type* p);
+            static bool          is_nothing(const interface_type* p);
+            static OP_CODE       op_code(const interface_type* p);
         };
 
         template <typename T>
@@ -247,66 +491,245 @@ namespace Olly {
             //                                 'data_type' Class Definition
             //
             //             The interface implementation of the 'interface_type' data type.
-            //             Defining a shared const pointer of the data type passed to it.
+            //             Its table only points to the operations 'T' overrides, and to
+            //             the operations which depend upon 'T'.
+            //
+            //             Each is allocated from the 'block_pool' by 'make', and returned
+            //             to it by 'destroy', unless OLLY_DEFAULT_ALLOCATOR is defined.
             //
             /******************************************************************************************/
 
             data_type(T val);
-            virtual ~data_type();
 
-            operator bool()                          const;
+            static data_type*    make(T val);                        // Allocate and construct a boxed object.
+
+#if defined(OLLY_INSTRUMENTATION)
+            static allocation_stats::counters& allocations(const interface_type* p);   // The allocation counters of 'T'.
+#endif
+
+            static const operations         table;          // The operations of 'T'.
+            static constexpr operations     make_table();
+
+            static const T&      self(const interface_type* p);      // The data held by the interface.
+            static T&           owned(interface_type* p);           // The data held by an interface only one 'var' references.
+            static void          destroy(const interface_type* p);
+
+            static const Text&   type(const interface_type* p);
+            static const Text&   cat(const interface_type* p);
+            static bool          is(const interface_type* p);
+            static void          str(const interface_type* p, Text_Stream& out);
+            static void          repr(const interface_type* p, Text_Stream& out);
+
+            static double        comp(const interface_type* p, const var& n);
+            static bool          equals(const interface_type* p, const var& n);
+
+            static var           b_and(const interface_type* p, const var& n);
+            static var           b_or(const interface_type* p, const var& n);
+            static var           b_xor(const interface_type* p, const var& n);
+            static var           b_neg(const interface_type* p);
+
+            static var           u_add(const interface_type* p);
+            static var           u_neg(const interface_type* p);
+
+            static var           add(const interface_type* p, const var& n);
+            static var           sub(const interface_type* p, const var& n);
+            static var           mul(const interface_type* p, const var& n);
+            static var           div(const interface_type* p, const var& n);
+            static var           mod(const interface_type* p, const var& n);
+
+            static var           f_div(const interface_type* p, const var& n);
+            static var           rem(const interface_type* p, const var& n);
+            static var           pow(const interface_type* p, const var& n);
+            static var           root(const interface_type* p, const var& n);
+
+            static bool          has(const interface_type* p, const var& n);
+            static std::size_t   size(const interface_type* p);
+            static var           lead(const interface_type* p);
+            static var           last(const interface_type* p);
+            static var           join(const interface_type* p, const var& n);
+            static var           join_move(const interface_type* p, var&& n);
+            static var           link(const interface_type* p, const var& n);
+            static var           link_move(const interface_type* p, var&& n);
+            static var           next(const interface_type* p);
+            static var           prev(const interface_type* p);
+            static var           drop(const interface_type* p, std::size_t n);
+            static var           take(const interface_type* p, std::size_t n);
+
+            static void          join_in_place(interface_type* p, var&& n);
+            static void          link_in_place(interface_type* p, var&& n);
+            static void          next_in_place(interface_type* p);
+            static void          prev_in_place(interface_type* p);
+
+            static var           reverse(const interface_type* p);
+
+            static var           get(const interface_type* p, const var& key);
+            static var           set(const interface_type* p, const var& key, const var& val);
+            static var           set_move(const interface_type* p, const var& key, var&& val);
+            static var           del(const interface_type* p, const var& key);
+
+            static std::size_t   hash(const interface_type* p);
+            static Text          help(const interface_type* p);
+            static bool          is_nothing(const interface_type* p);
+            static OP_CODE       op_code(const interface_type* p);
 
-            Text            _type()                  const;
-            Text            _cat()                   const;
-            bool            _is()                    const;
-            void            _str(Text_Stream& out)   const;
-            void            _repr(Text_Stream& out)  const;
+            T              _data;
+        };
 
-            double         _comp(var n)              const;
+        class interface_handle {
 
-            var            _b_and(var n)             const;
-            var            _b_or(var n)              const;
-            var            _b_xor(var n)             const;
-            var            _b_neg()                  const;
+            /******************************************************************************************/
+            //
+            //                              'interface_handle' Class Definition
+            //
+            //             Resolves a 'var' to the 'interface_type' its calls are made on.
+            //             Boxed values are referenced directly.  Immediate values are
+            //             materialized within the handle for the duration of the call.
+            //
+            /******************************************************************************************/
 
-            var            _u_add()                  const;
-            var            _u_neg()                  const;
+        public:
 
-            var            _add(var n)               const;
-            var            _sub(var n)               const;
-            var            _mul(var n)               const;
-            var            _div(var n)               const;
-            var            _mod(var n)               const;
+            interface_handle(const var& n);
+            interface_handle(const interface_handle&) = delete;
 
-            var            _f_div(var n)             const;
-            var            _rem(var n)               const;
-            var            _pow(var n)               const;
-            var            _root(var n)              const;
+            const interface_type* operator->()      const;
 
-            bool           _has(var n)               const;
-            std::size_t    _size()                   const;
-            var            _lead()                   const;
-            var            _last()                   const;
-            var            _join(var n)              const;
-            var            _link(var n)              const;
-            var            _next()                   const;
-            var            _prev()                   const;
+        private:
 
-            var            _get(var key)             const;
-            var            _set(var key, var val)    const;
-            var            _del(var key)             const;
+            alignas(data_type<double>) unsigned char _buffer[sizeof(data_type<double>)];
 
-            var            _reverse()                const;
+            const interface_type* _ptr;
+        };
 
-            std::size_t     _hash()                  const;
-            Text           _help()                   const;
-            bool           _is_nothing()             const;
-            OP_CODE        _op_code()                const;
+        /********************************************************************************************/
+        //
+        //                               Immediate Value Encoding
+        //
+        //          The scalars 'bool', 'int', 'long' and 'double', as well as 'nothing', are
+        //          held within '_word' itself, and never allocate.  Any word which is not
+        //          one of the tagged quiet NaN patterns below is a 'double'.  All NaN's are
+        //          stored as 'canonical_nan' so they never collide with a tag.  A 'long'
+        //          outside of the 48 bit payload range is boxed like any other type.
+        //
+        //          Boxed values store their 'interface_type' pointer in the payload, so a
+        //          'var' is always exactly one word.  Every heap address must therefore
+        //          fit within 48 bits, with its upper 16 bits clear.  This holds for x64
+        //          and AArch64 with 4 level paging, but not with 5 level paging (LA57) or
+        //          with tagged pointers (TBI or MTE), which are not supported.  A debug
+        //          build asserts each address boxed fits.
+        //
+        /********************************************************************************************/
+
+        static constexpr std::uint64_t tag_mask      = 0xFFFF000000000000ULL;
+        static constexpr std::uint64_t payload_mask  = 0x0000FFFFFFFFFFFFULL;
+        static constexpr std::uint64_t canonical_nan = 0x7FF8000000000000ULL;
+
+        static constexpr std::uint64_t nothing_tag   = 0xFFF9000000000000ULL;
+        static constexpr std::uint64_t bool_tag      = 0xFFFA000000000000ULL;
+        static constexpr std::uint64_t int_tag       = 0xFFFB000000000000ULL;
+        static constexpr std::uint64_t long_tag      = 0xFFFC000000000000ULL;
+        static constexpr std::uint64_t boxed_tag     = 0xFFFD000000000000ULL;
 
-            T              _data;
-        };
+        template <typename T>
+        static constexpr bool is_immediate = is_immediate_type<T>;
+
+        template <typename T> static bool encode(const T& x, std::uint64_t& word);  // Encode an immediate value, false if it must be boxed.
+        template <typename T>        bool holds()                              const;  // Is the word an immediate of the specified type.
+        template <typename T>           T decode()                             const;  // Decode the immediate value held by the word.
+
+        template <typename T>  const T*   boxed()                              const;  // The boxed data of the specified type, else a null pointer.
+
+        bool                        is_boxed()                                const;
+        interface_type*              pointer()                                const;
+        interface_type*                owned()                                const;  // The boxed object, if only this 'var' references it, else a null pointer.
+        void                          retain()                                const;
+        void                         release();
+
+        interface_handle           _interface()                               const;
+
+        friend void                    dispose(const interface_type* p);  // Destroy a boxed object, once its last reference is released.
+
+        static const interface_type*  nothing_interface();  // The immortal 'nothing' instance all immediate 'nothing' values share.
+
+        std::uint64_t _word;
+    };
+
+
+
+    /********************************************************************************************/
+    //
+    //                                'var_ref' Class Definition
+    //
+    //          A borrowed, non-owning view of a 'var'.  Making, copying and passing a
+    //          'var_ref' never counts a reference, so it must not outlive the 'var' it
+    //          refers to.  It can not be made from a temporary for that reason.  Any
+    //          'var' made from a 'var_ref' takes a reference of its own.
+    //
+    /********************************************************************************************/
 
-        std::shared_ptr<const interface_type> _ptr;
+    class var_ref {
+
+        const var* _var;
+
+    public:
+
+        var_ref(const var& n);
+        var_ref(var&& n) = delete;
+
+        const var&  operator*()                     const;
+        const var*  operator->()                    const;
+
+        operator const var&()                       const;
+    };
+
+
+
+    /********************************************************************************************/
+    //
+    //                                'var_ptr' Class Definition
+    //
+    //          The result of 'var::cast'.  A non-owning pointer to the data held by a
+    //          'var', which is null when the 'var' does not hold the specified type.
+    //          It is valid for as long as the 'var' it was cast from.  Casting never
+    //          allocates, or uses run-time type information.
+    //
+    //          Immediate values are not held within a 'data_type', so a 'var_ptr' to an
+    //          immediate type holds a copy of the value instead.
+    //
+    /********************************************************************************************/
+
+    template <typename T>
+    class var_ptr<T, false> {
+
+        const T* _ptr;
+
+    public:
+
+        var_ptr(const T* ptr);
+
+        const T*    get()                           const;
+        const T&    operator*()                     const;
+        const T*    operator->()                    const;
+
+        explicit operator bool()                    const;
+    };
+
+    template <typename T>
+    class var_ptr<T, true> {
+
+        T    _value;
+        bool _valid;
+
+    public:
+
+        var_ptr();
+        var_ptr(T value);
+
+        const T*    get()                           const;
+        const T&    operator*()                     const;
+        const T*    operator->()                    const;
+
+        explicit operator bool()                    const;
     };
 
 
@@ -323,6 +746,10 @@ namespace Olly {
     //          This class also demonstrates the basic function methods that should be
     //          over written for proper object behavior.
     //
+    //          A 'var' of nothing is an immediate value.  Every one of them shares a
+    //          single immortal instance, so constructing, copying and destroying
+    //          nothing never allocates or counts references.
+    //
     /********************************************************************************************/
 
     class nothing {
@@ -331,7 +758,7 @@ namespace Olly {
 
         friend Text          _type_(const nothing& self);
         friend bool            _is_(const nothing& self);
-        friend double        _comp_(const nothing& self, var n);
+        friend double        _comp_(const nothing& self, const var& n);
 
         friend void           _str_(Text_Stream& out, const nothing& self);
         friend void          _repr_(Text_Stream& out, const nothing& self);
@@ -349,8 +776,11 @@ namespace Olly {
     //
     /********************************************************************************************/
 
-    Text  str(var a);          // Convert any 'var' to a Text.
-    Text repr(var a);          // Convert any 'var' to a Text representation of the 'var'.
+    Text  str(const var& a);   // Convert any 'var' to a Text.
+    Text repr(const var& a);   // Convert any 'var' to a Text representation of the 'var'.
+
+    void  stream_str(const var& a, text_sink sink, std::size_t chunk_size = text_writer::default_chunk_size);  // Write 'str' to a sink in chunks.
+    void stream_repr(const var& a, text_sink sink, std::size_t chunk_size = text_writer::default_chunk_size);  // Write 'repr' to a sink in chunks.
 
     var pop_lead(var& exp);    // Remove and return the lead element from an ordered expression.
     var pop_last(var& exp);    // Remove and return the last element from an ordered expression.
@@ -429,37 +859,46 @@ namespace Olly {
 
 
     template<typename T>            /****  Comparison Between Variables  ****/
-    double _comp_(const T& self, var other);
+    double _comp_(const T& self, const var& other);
 
     template<typename T>
-    double _comp_(const T& self, var other) {
+    double _comp_(const T& self, const var& other) {
         return NOT_A_NUMBER;
     }
 
 
+    template<typename T>            /****  Equality Between Variables  ****/
+    bool _equals_(const T& self, const var& other);
+
+    template<typename T>
+    bool _equals_(const T& self, const var& other) {
+        return _comp_(self, other) == 0.0;
+    }
+
+
     template<typename T>            /****  Logical Conjunction  ****/
-    var _b_and_(const T& self, var other);
+    var _b_and_(const T& self, const var& other);
 
     template<typename T>
-    var _b_and_(const T& self, var other) {
+    var _b_and_(const T& self, const var& other) {
         return var();
     }
 
 
     template<typename T>            /****  Logical Inclusive Disjunction  ****/
-    var _b_or_(const T& self, var other);
+    var _b_or_(const T& self, const var& other);
 
     template<typename T>
-    var _b_or_(const T& self, var other) {
+    var _b_or_(const T& self, const var& other) {
         return var();
     }
 
 
     template<typename T>            /****  Logical Exclusive Disjunction  ****/
-    var _b_xor_(const T& self, var other);
+    var _b_xor_(const T& self, const var& other);
 
     template<typename T>
-    var _b_xor_(const T& self, var other) {
+    var _b_xor_(const T& self, const var& other) {
         return var();
     }
 
@@ -492,90 +931,90 @@ namespace Olly {
 
 
     template<typename T>            /****  Addition or Concatenation  ****/
-    var _add_(const T& self, var other);
+    var _add_(const T& self, const var& other);
 
     template<typename T>
-    var _add_(const T& self, var other) {
+    var _add_(const T& self, const var& other) {
         return var();
     }
 
 
     template<typename T>            /****  Subtraction or Division  ****/
-    var _sub_(const T& self, var other);
+    var _sub_(const T& self, const var& other);
 
     template<typename T>
-    var _sub_(const T& self, var other) {
+    var _sub_(const T& self, const var& other) {
         return var();
     }
 
 
     template<typename T>            /****  Multiplication  ****/
-    var _mul_(const T& self, var other);
+    var _mul_(const T& self, const var& other);
 
     template<typename T>
-    var _mul_(const T& self, var other) {
+    var _mul_(const T& self, const var& other) {
         return var();
     }
 
 
     template<typename T>            /****  Division  ****/
-    var _div_(const T& self, var other);
+    var _div_(const T& self, const var& other);
 
     template<typename T>
-    var _div_(const T& self, var other) {
+    var _div_(const T& self, const var& other) {
         return var();
     }
 
     template<typename T>            /****  Modulation  ****/
-    var _mod_(const T& self, var other);
+    var _mod_(const T& self, const var& other);
 
     template<typename T>
-    var _mod_(const T& self, var other) {
+    var _mod_(const T& self, const var& other) {
         return var();
     }
 
 
     template<typename T>            /****  Floor Division  ****/
-    var _f_div_(const T& self, var other);
+    var _f_div_(const T& self, const var& other);
 
     template<typename T>
-    var _f_div_(const T& self, var other) {
+    var _f_div_(const T& self, const var& other) {
         return var();
     }
 
 
     template<typename T>            /****  Remainder  ****/
-    var _rem_(const T& self, var other);
+    var _rem_(const T& self, const var& other);
 
     template<typename T>
-    var _rem_(const T& self, var other) {
+    var _rem_(const T& self, const var& other) {
         return var();
     }
 
 
     template<typename T>            /****  Raise to Power of  ****/
-    var _pow_(const T& self, var other);
+    var _pow_(const T& self, const var& other);
 
     template<typename T>
-    var _pow_(const T& self, var other) {
+    var _pow_(const T& self, const var& other) {
         return var();
     }
 
 
     template<typename T>            /****  Reduce to Power of  ****/
-    var _root_(const T& self, var other);
+    var _root_(const T& self, const var& other);
 
     template<typename T>
-    var _root_(const T& self, var other) {
+    var _root_(const T& self, const var& other) {
         return var();
     }
 
 
     template<typename T>            /****  Check if an object has an element  ****/
-    bool _has_(const T& self, var other);
+    bool _has_(const T& self, const var& other);
 
     template<typename T>
-    bool _has_(const T& self, var other) {
+    bool _has_(const T& self, const var& other) {
         return false;
     }
 
@@ -608,22 +1047,38 @@ namespace Olly {
 
 
     template<typename T>            /**** Prepend Lead Element Of  ****/
-    var _join_(const T& self, var other);
+    var _join_(const T& self, const var& other);
 
     template<typename T>
-    var _join_(const T& self, var other) {
+    var _join_(const T& self, const var& other) {
         return var();
     }
 
+    template<typename T>
+    var _join_(const T& self, var&& other);
+
+    template<typename T>
+    var _join_(const T& self, var&& other) {
+        return _join_(self, static_cast<const var&>(other));
+    }
+
 
     template<typename T>            /**** Prepend Lead Element Of  ****/
-    var _link_(const T& self, var other);
+    var _link_(const T& self, const var& other);
 
     template<typename T>
-    var _link_(const T& self, var other) {
+    var _link_(const T& self, const var& other) {
         return var();
     }
 
+    template<typename T>
+    var _link_(const T& self, var&& other);
+
+    template<typename T>
+    var _link_(const T& self, var&& other) {
+        return _link_(self, static_cast<const var&>(other));
+    }
+
 
     template<typename T>            /****  Drop The Leading Element  ****/
     var _next_(const T& self);
@@ -643,6 +1098,24 @@ namespace Olly {
     }
 
 
+    template<typename T>            /****  Drop The Leading Elements  ****/
+    var _drop_(const T& self, std::size_t n);
+
+    template<typename T>
+    var _drop_(const T& self, std::size_t n) {
+        return var();
+    }
+
+
+    template<typename T>            /****  Take The Leading Elements  ****/
+    var _take_(const T& self, std::size_t n);
+
+    template<typename T>
+    var _take_(const T& self, std::size_t n) {
+        return var();
+    }
+
+
     template<typename T>            /****  Reverse The Elements Of  ****/
     var _reverse_(const T& self);
 
@@ -653,28 +1126,28 @@ namespace Olly {
 
 
     template<typename T>            /****  Retrieve A Selection From  ****/
-    var _get_(const T& self, var other);
+    var _get_(const T& self, const var& other);
 
     template<typename T>
-    var _get_(const T& self, var other) {
+    var _get_(const T& self, const var& other) {
         return var();
     }
 
 
     template<typename T>            /****  Set A Selection Of  ****/
-    var _set_(const T& self, var other, var val);
+    var _set_(const T& self, const var& other, const var& val);
 
     template<typename T>
-    var _set_(const T& self, var other, var val) {
+    var _set_(const T& self, const var& other, const var& val) {
         return var();
     }
 
 
     template<typename T>            /****  Remove A Selection From  ****/
-    var _del_(const T& self, var other);
+    var _del_(const T& self, const var& other);
 
     template<typename T>
-    var _del_(const T& self, var other) {
+    var _del_(const T& self, const var& other) {
         return var();
     }
 
@@ -684,7 +1157,13 @@ namespace Olly {
 
     template<typename T>
     std::size_t _hash_(const T& self) {
-        return DEFAULT_HASH_FUNCTION(repr(self));
+
+        if constexpr (has_hash_value<T>) {
+            return hash_value(self);
+        }
+        else {
+            return hash_value(repr(self));
+        }
     }
 
 
@@ -715,568 +1194,2650 @@ namespace Olly {
     }
 
 
-    std::ostream& operator<<(std::ostream& stream, var n) {
+    std::ostream& operator<<(std::ostream& stream, const var& n) {
+        /*
+            Honor the formatting of the stream the writer
+            understands, then copy the text in one write.
+        */
+
+        writer_lease out;
 
-        Text_Stream out;
+        const std::ios_base::fmtflags flags = stream.flags();
 
-        out.copyfmt(stream);
+        out->boolalpha(flags & std::ios_base::boolalpha);
+        out->base((flags & std::ios_base::hex) ? 16 : (flags & std::ios_base::oct) ? 8 : 10);
+        out->precision(static_cast<int>(stream.precision()));
 
-        n.str(out);
+        n.str(*out);
 
-        stream << out.str();
+        stream.write(out->data(), static_cast<std::streamsize>(out->size()));
 
         return stream;
     }
 
+    Text_Stream& operator<<(Text_Stream& out, const var& n) {
+
+        n.str(out);
+
+        return out;
+    }
+
 
 
 
     /********************************************************************************************/
     //
-    //                                 'nothing' Class Implementation
+    //                                   Override Detection
+    //
+    //          Detects at compile time which '_op_' functions a type overrides.  Within
+    //          'op_probe' each default is joined by a template which matches equally as
+    //          well, but is never defined.  A call resolved by the defaults is therefore
+    //          ambiguous, and the call is only well formed when the type overrides the
+    //          function.
     //
     /********************************************************************************************/
 
-    Text _type_(const nothing& self) {
-        return "nothing";
-    }
+    namespace op_probe {
 
-    bool _is_(const nothing& self) {
-        return false;
-    }
+        struct not_overridden {};
 
-    double _comp_(const nothing& self, var n) {
-        return NOT_A_NUMBER;
-    }
+        using Olly::_type_;
+        template <typename T> not_overridden _type_(const T& self);
 
-    void _str_(Text_Stream& out, const nothing& self) {
-        out << "nothing";
-    }
+        using Olly::_cat_;
+        template <typename T> not_overridden _cat_(const T& self);
 
-    void _repr_(Text_Stream& out, const nothing& self) {
-        out << "nothing";
-    }
+        using Olly::_is_;
+        template <typename T> not_overridden _is_(const T& self);
 
-    bool _is_nothing_(const nothing& self) {
-        return true;
-    }
+        using Olly::_str_;
+        template <typename T> not_overridden _str_(Text_Stream& out, const T& self);
 
+        using Olly::_repr_;
+        template <typename T> not_overridden _repr_(Text_Stream& out, const T& self);
 
+        using Olly::_comp_;
+        template <typename T> not_overridden _comp_(const T& self, const var& other);
 
+        using Olly::_equals_;
+        template <typename T> not_overridden _equals_(const T& self, const var& other);
 
-    /********************************************************************************************/
-    //
-    //                                'var' Class Implementation
-    //
-    /********************************************************************************************/
+        using Olly::_b_and_;
+        template <typename T> not_overridden _b_and_(const T& self, const var& other);
 
-    var::var() : _ptr(std::make_shared<data_type<nothing>>(nothing())) {
-    }
+        using Olly::_b_or_;
+        template <typename T> not_overridden _b_or_(const T& self, const var& other);
 
-    template <typename T>
-    var::var(T x) : _ptr(std::make_shared<data_type<T>>(std::move(x))) {
-    }
+        using Olly::_b_xor_;
+        template <typename T> not_overridden _b_xor_(const T& self, const var& other);
 
-    template <typename T>
-    std::shared_ptr<const T> var::cast() const {
+        using Olly::_b_neg_;
+        template <typename T> not_overridden _b_neg_(const T& self);
 
-        const T* p = dynamic_cast<T*>(const_cast<interface_type*>(_ptr.get()));
+        using Olly::_u_add_;
+        template <typename T> not_overridden _u_add_(const T& self);
 
-        return std::make_shared<const T>(p);
-    }
+        using Olly::_u_neg_;
+        template <typename T> not_overridden _u_neg_(const T& self);
 
-    template <typename T> 
-    T var::copy() const {
+        using Olly::_add_;
+        template <typename T> not_overridden _add_(const T& self, const var& other);
 
-        const T* p = dynamic_cast<T*>(const_cast<interface_type*>(_ptr.get()));
+        using Olly::_sub_;
+        template <typename T> not_overridden _sub_(const T& self, const var& other);
 
-        if (p) {
-            return T{ *p };
-        }
+        using Olly::_mul_;
+        template <typename T> not_overridden _mul_(const T& self, const var& other);
 
-        return T{};
-    }
+        using Olly::_div_;
+        template <typename T> not_overridden _div_(const T& self, const var& other);
 
-    Text var::type() const {
-        return _ptr->_type();
-    }
+        using Olly::_mod_;
+        template <typename T> not_overridden _mod_(const T& self, const var& other);
 
-    Text var::cat() const {
-        return _ptr->_cat();
-    }
+        using Olly::_f_div_;
+        template <typename T> not_overridden _f_div_(const T& self, const var& other);
 
-    bool var::is() const {
-        return const_cast<interface_type*>(_ptr.get())->_is();
-    }
+        using Olly::_rem_;
+        template <typename T> not_overridden _rem_(const T& self, const var& other);
 
-    void var::str(Text_Stream& out) const {
-        _ptr->_str(out);
-    }
+        using Olly::_pow_;
+        template <typename T> not_overridden _pow_(const T& self, const var& other);
 
-    void var::repr(Text_Stream& out) const {
-        _ptr->_repr(out);
-    }
+        using Olly::_root_;
+        template <typename T> not_overridden _root_(const T& self, const var& other);
 
-    double var::comp(var n) const {
-        return _ptr->_comp(n);
-    }
+        using Olly::_has_;
+        template <typename T> not_overridden _has_(const T& self, const var& other);
 
-    bool var::eq(var n) const {
-        return (comp(n) == 0.0 ? true : false);
-    }
+        using Olly::_size_;
+        template <typename T> not_overridden _size_(const T& self);
 
-    bool var::ne(var n) const {
-        return (comp(n) != 0.0 ? true : false);
-    }
+        using Olly::_lead_;
+        template <typename T> not_overridden _lead_(const T& self);
 
-    bool var::ge(var n) const {
-        return (comp(n) >= 0.0 ? true : false);
-    }
+        using Olly::_last_;
+        template <typename T> not_overridden _last_(const T& self);
 
-    bool var::le(var n) const {
-        return (comp(n) <= 0.0 ? true : false);
-    }
+        using Olly::_join_;
+        template <typename T> not_overridden _join_(const T& self, const var& other);
+        template <typename T> not_overridden _join_(const T& self, var&& other);
 
-    bool var::gt(var n) const {
-        return (comp(n) > 0.0 ? true : false);
-    }
+        using Olly::_link_;
+        template <typename T> not_overridden _link_(const T& self, const var& other);
+        template <typename T> not_overridden _link_(const T& self, var&& other);
 
-    bool var::lt(var n) const {
-        return (comp(n) < 0.0 ? true : false);
-    }
+        using Olly::_next_;
+        template <typename T> not_overridden _next_(const T& self);
 
-    var var::b_and(var n) const {
-        return _ptr->_b_and(n);
-    }
+        using Olly::_prev_;
+        template <typename T> not_overridden _prev_(const T& self);
 
-    var var::b_or(var n) const {
-        return _ptr->_b_or(n);
-    }
+        using Olly::_drop_;
+        template <typename T> not_overridden _drop_(const T& self, std::size_t n);
 
-    var var::b_xor(var n) const {
-        return _ptr->_b_xor(n);
-    }
+        using Olly::_take_;
+        template <typename T> not_overridden _take_(const T& self, std::size_t n);
 
-    var var::b_neg() const {
-        return _ptr->_b_neg();
-    }
+        using Olly::_reverse_;
+        template <typename T> not_overridden _reverse_(const T& self);
 
-    var var::operator&(var n) const {
-        return b_and(n);
-    }
+        using Olly::_get_;
+        template <typename T> not_overridden _get_(const T& self, const var& other);
 
-    var var::operator|(var n) const {
-        return b_or(n);
-    }
+        using Olly::_set_;
+        template <typename T> not_overridden _set_(const T& self, const var& other, const var& val);
+        template <typename T> not_overridden _set_(const T& self, const var& other, var&& val);
 
-    var var::operator^(var n) const {
-        return b_xor(n);
-    }
+        using Olly::_del_;
+        template <typename T> not_overridden _del_(const T& self, const var& other);
 
-    var var::operator~() const {
-        return b_neg();
-    }
+        using Olly::_hash_;
+        template <typename T> not_overridden _hash_(const T& self);
 
-    var var::u_add() const {
-        return _ptr->_u_add();
-    }
+        using Olly::_help_;
+        template <typename T> not_overridden _help_(const T& self);
 
-    var var::u_neg() const {
-        return _ptr->_u_neg();
-    }
+        using Olly::_is_nothing_;
+        template <typename T> not_overridden _is_nothing_(const T& self);
 
-    var var::add(var n) const {
-        return _ptr->_add(n);
-    }
+        using Olly::_op_code_;
+        template <typename T> not_overridden _op_code_(const T& self);
 
-    var var::sub(var n) const {
-        return _ptr->_sub(n);
-    }
+        template <typename T, typename = void>
+        constexpr bool type = false;
 
-    var var::mul(var n) const {
-        return _ptr->_mul(n);
-    }
+        template <typename T>
+        constexpr bool type<T, std::void_t<decltype(_type_(std::declval<const T&>()))>> = true;
 
-    var var::div(var n) const {
-        return _ptr->_div(n);
-    }
+        template <typename T, typename = void>
+        constexpr bool cat = false;
 
-    var var::mod(var n) const {
-        return _ptr->_mod(n);
-    }
+        template <typename T>
+        constexpr bool cat<T, std::void_t<decltype(_cat_(std::declval<const T&>()))>> = true;
 
-    var var::operator+() const {
-        return u_add();
-    }
+        template <typename T, typename = void>
+        constexpr bool is = false;
 
-    var var::operator-() const {
-        return u_neg();
-    }
+        template <typename T>
+        constexpr bool is<T, std::void_t<decltype(_is_(std::declval<const T&>()))>> = true;
 
-    var var::f_div(var n) const {
-        return _ptr->_f_div(n);
-    }
+        template <typename T, typename = void>
+        constexpr bool str = false;
 
-    var var::rem(var n) const {
-        return _ptr->_rem(n);
-    }
+        template <typename T>
+        constexpr bool str<T, std::void_t<decltype(_str_(std::declval<Text_Stream&>(), std::declval<const T&>()))>> = true;
 
-    var var::pow(var n) const {
-        return _ptr->_pow(n);
-    }
+        template <typename T, typename = void>
+        constexpr bool repr = false;
 
-    var var::root(var n) const {
-        return _ptr->_root(n);
-    }
+        template <typename T>
+        constexpr bool repr<T, std::void_t<decltype(_repr_(std::declval<Text_Stream&>(), std::declval<const T&>()))>> = true;
 
-    bool var::has(var n) const {
-        return _ptr->_has(n);
-    }
+        template <typename T, typename = void>
+        constexpr bool comp = false;
 
-    std::size_t var::size() const {
-        return _ptr->_size();
-    }
+        template <typename T>
+        constexpr bool comp<T, std::void_t<decltype(_comp_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
 
-    var var::lead() const {
-        return _ptr->_lead();
-    }
+        template <typename T, typename = void>
+        constexpr bool equals = false;
 
-    var var::last() const {
-        return _ptr->_last();
-    }
+        template <typename T>
+        constexpr bool equals<T, std::void_t<decltype(_equals_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
 
-    var var::join(var n) const {
-        return _ptr->_join(n);
-    }
+        template <typename T, typename = void>
+        constexpr bool b_and = false;
 
-    var var::link(var n) const {
-        return _ptr->_link(n);
-    }
+        template <typename T>
+        constexpr bool b_and<T, std::void_t<decltype(_b_and_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
 
-    var var::next() const {
-        return _ptr->_next();
-    }
+        template <typename T, typename = void>
+        constexpr bool b_or = false;
 
-    var var::prev() const {
-        return _ptr->_prev();
-    }
+        template <typename T>
+        constexpr bool b_or<T, std::void_t<decltype(_b_or_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
 
-    var var::operator>>(std::size_t shift) const {
+        template <typename T, typename = void>
+        constexpr bool b_xor = false;
 
-        var a{ *this };
+        template <typename T>
+        constexpr bool b_xor<T, std::void_t<decltype(_b_xor_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
 
-        while (shift--) {
+        template <typename T, typename = void>
+        constexpr bool b_neg = false;
 
-            a = a.next();
-        }
+        template <typename T>
+        constexpr bool b_neg<T, std::void_t<decltype(_b_neg_(std::declval<const T&>()))>> = true;
 
-        return a;
-    }
+        template <typename T, typename = void>
+        constexpr bool u_add = false;
 
-    var var::operator<<(std::size_t shift) const {
+        template <typename T>
+        constexpr bool u_add<T, std::void_t<decltype(_u_add_(std::declval<const T&>()))>> = true;
 
-        var a{ *this };
+        template <typename T, typename = void>
+        constexpr bool u_neg = false;
 
-        while (shift--) {
+        template <typename T>
+        constexpr bool u_neg<T, std::void_t<decltype(_u_neg_(std::declval<const T&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool add = false;
+
+        template <typename T>
+        constexpr bool add<T, std::void_t<decltype(_add_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool sub = false;
+
+        template <typename T>
+        constexpr bool sub<T, std::void_t<decltype(_sub_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool mul = false;
+
+        template <typename T>
+        constexpr bool mul<T, std::void_t<decltype(_mul_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool div = false;
+
+        template <typename T>
+        constexpr bool div<T, std::void_t<decltype(_div_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool mod = false;
+
+        template <typename T>
+        constexpr bool mod<T, std::void_t<decltype(_mod_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool f_div = false;
+
+        template <typename T>
+        constexpr bool f_div<T, std::void_t<decltype(_f_div_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool rem = false;
+
+        template <typename T>
+        constexpr bool rem<T, std::void_t<decltype(_rem_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool pow = false;
+
+        template <typename T>
+        constexpr bool pow<T, std::void_t<decltype(_pow_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool root = false;
+
+        template <typename T>
+        constexpr bool root<T, std::void_t<decltype(_root_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool has = false;
+
+        template <typename T>
+        constexpr bool has<T, std::void_t<decltype(_has_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool size = false;
+
+        template <typename T>
+        constexpr bool size<T, std::void_t<decltype(_size_(std::declval<const T&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool lead = false;
+
+        template <typename T>
+        constexpr bool lead<T, std::void_t<decltype(_lead_(std::declval<const T&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool last = false;
+
+        template <typename T>
+        constexpr bool last<T, std::void_t<decltype(_last_(std::declval<const T&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool join = false;
+
+        template <typename T>
+        constexpr bool join<T, std::void_t<decltype(_join_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool join_move = false;
+
+        template <typename T>
+        constexpr bool join_move<T, std::void_t<decltype(_join_(std::declval<const T&>(), std::declval<var>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool link = false;
+
+        template <typename T>
+        constexpr bool link<T, std::void_t<decltype(_link_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool link_move = false;
+
+        template <typename T>
+        constexpr bool link_move<T, std::void_t<decltype(_link_(std::declval<const T&>(), std::declval<var>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool next = false;
+
+        template <typename T>
+        constexpr bool next<T, std::void_t<decltype(_next_(std::declval<const T&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool prev = false;
+
+        template <typename T>
+        constexpr bool prev<T, std::void_t<decltype(_prev_(std::declval<const T&>()))>> = true;
+
+        /*
+            A type changes itself in place by overloading the '_op_'
+            function for a mutable 'self', returning nothing.
+        */
+
+        template <typename T, typename = void>
+        constexpr bool join_in_place = false;
+
+        template <typename T>
+        constexpr bool join_in_place<T, std::enable_if_t<std::is_void_v<decltype(_join_(std::declval<T&>(), std::declval<var>()))>>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool link_in_place = false;
+
+        template <typename T>
+        constexpr bool link_in_place<T, std::enable_if_t<std::is_void_v<decltype(_link_(std::declval<T&>(), std::declval<var>()))>>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool next_in_place = false;
+
+        template <typename T>
+        constexpr bool next_in_place<T, std::enable_if_t<std::is_void_v<decltype(_next_(std::declval<T&>()))>>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool prev_in_place = false;
+
+        template <typename T>
+        constexpr bool prev_in_place<T, std::enable_if_t<std::is_void_v<decltype(_prev_(std::declval<T&>()))>>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool drop = false;
+
+        template <typename T>
+        constexpr bool drop<T, std::void_t<decltype(_drop_(std::declval<const T&>(), std::declval<std::size_t>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool take = false;
+
+        template <typename T>
+        constexpr bool take<T, std::void_t<decltype(_take_(std::declval<const T&>(), std::declval<std::size_t>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool reverse = false;
+
+        template <typename T>
+        constexpr bool reverse<T, std::void_t<decltype(_reverse_(std::declval<const T&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool get = false;
+
+        template <typename T>
+        constexpr bool get<T, std::void_t<decltype(_get_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool set = false;
+
+        template <typename T>
+        constexpr bool set<T, std::void_t<decltype(_set_(std::declval<const T&>(), std::declval<const var&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool set_move = false;
+
+        template <typename T>
+        constexpr bool set_move<T, std::void_t<decltype(_set_(std::declval<const T&>(), std::declval<const var&>(), std::declval<var>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool del = false;
+
+        template <typename T>
+        constexpr bool del<T, std::void_t<decltype(_del_(std::declval<const T&>(), std::declval<const var&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool hash = false;
+
+        template <typename T>
+        constexpr bool hash<T, std::void_t<decltype(_hash_(std::declval<const T&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool help = false;
+
+        template <typename T>
+        constexpr bool help<T, std::void_t<decltype(_help_(std::declval<const T&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool is_nothing = false;
+
+        template <typename T>
+        constexpr bool is_nothing<T, std::void_t<decltype(_is_nothing_(std::declval<const T&>()))>> = true;
+
+        template <typename T, typename = void>
+        constexpr bool op_code = false;
+
+        template <typename T>
+        constexpr bool op_code<T, std::void_t<decltype(_op_code_(std::declval<const T&>()))>> = true;
+
+        template <typename T>
+        constexpr std::uint64_t capabilities =
+            (type<T>        ? capability_bit(capability::type)            : 0)
+          | (cat<T>         ? capability_bit(capability::cat)             : 0)
+          | (is<T>          ? capability_bit(capability::is)              : 0)
+          | (str<T>         ? capability_bit(capability::str)             : 0)
+          | (repr<T>        ? capability_bit(capability::repr)            : 0)
+          | (comp<T>        ? capability_bit(capability::comp)            : 0)
+          | (equals<T>      ? capability_bit(capability::equals)          : 0)
+          | (b_and<T>       ? capability_bit(capability::b_and)           : 0)
+          | (b_or<T>        ? capability_bit(capability::b_or)            : 0)
+          | (b_xor<T>       ? capability_bit(capability::b_xor)           : 0)
+          | (b_neg<T>       ? capability_bit(capability::b_neg)           : 0)
+          | (u_add<T>       ? capability_bit(capability::u_add)           : 0)
+          | (u_neg<T>       ? capability_bit(capability::u_neg)           : 0)
+          | (add<T>         ? capability_bit(capability::add)             : 0)
+          | (sub<T>         ? capability_bit(capability::sub)             : 0)
+          | (mul<T>         ? capability_bit(capability::mul)             : 0)
+          | (div<T>         ? capability_bit(capability::div)             : 0)
+          | (mod<T>         ? capability_bit(capability::mod)             : 0)
+          | (f_div<T>       ? capability_bit(capability::f_div)           : 0)
+          | (rem<T>         ? capability_bit(capability::rem)             : 0)
+          | (pow<T>         ? capability_bit(capability::pow)             : 0)
+          | (root<T>        ? capability_bit(capability::root)            : 0)
+          | (has<T>         ? capability_bit(capability::has)             : 0)
+          | (size<T>        ? capability_bit(capability::size)            : 0)
+          | (lead<T>        ? capability_bit(capability::lead)            : 0)
+          | (last<T>        ? capability_bit(capability::last)            : 0)
+          | (join<T>        ? capability_bit(capability::join)            : 0)
+          | (join_move<T>   ? capability_bit(capability::join)            : 0)
+          | (link<T>        ? capability_bit(capability::link)            : 0)
+          | (link_move<T>   ? capability_bit(capability::link)            : 0)
+          | (next<T>        ? capability_bit(capability::next)            : 0)
+          | (prev<T>        ? capability_bit(capability::prev)            : 0)
+          | (drop<T>        ? capability_bit(capability::drop)            : 0)
+          | (take<T>        ? capability_bit(capability::take)            : 0)
+          | (reverse<T>     ? capability_bit(capability::reverse)         : 0)
+          | (get<T>         ? capability_bit(capability::get)             : 0)
+          | (set<T>         ? capability_bit(capability::set)             : 0)
+          | (set_move<T>    ? capability_bit(capability::set)             : 0)
+          | (del<T>         ? capability_bit(capability::del)             : 0)
+          | (hash<T>        ? capability_bit(capability::hash)            : 0)
+          | (help<T>        ? capability_bit(capability::help)            : 0)
+          | (is_nothing<T>  ? capability_bit(capability::is_nothing)      : 0)
+          | (op_code<T>     ? capability_bit(capability::op_code)         : 0);
+    }
+
+    template <typename T, capability op>    // Does the type override the '_op_' function named by 'op'.
+    constexpr bool has_override = (op_probe::capabilities<T> & capability_bit(op)) != 0;
+
+    /********************************************************************************************/
+    //
+    //                                 'text_cache_policy' Definition
+    //
+    //          Defining OLLY_CACHED_TEXT lets each boxed object cache its 'str' and
+    //          'repr', filled the first time each is written in the format used by
+    //          'str' and 'repr', and freed with the object.  The data is immutable, so
+    //          its text never changes.
+    //
+    //          By default only text written by an overridden '_str_' or '_repr_' is
+    //          cached, and only up to 'max_size' characters.  The policy may be
+    //          specialized for a type, to change either.  Immediate values are held
+    //          in the 'var' itself, and are never cached.
+    //
+    /********************************************************************************************/
+
+    template <typename T>
+    struct text_cache_policy {
+
+        static constexpr bool        str      = has_override<T, capability::str>;    // Cache the 'str' of the type.
+        static constexpr bool        repr     = has_override<T, capability::repr>;   // Cache the 'repr' of the type.
+        static constexpr std::size_t max_size = 4096;                                 // The longest text cached.
+    };
+
+
+
+
+    /********************************************************************************************/
+    //
+    //                                 'nothing' Class Implementation
+    //
+    /********************************************************************************************/
+
+    Text _type_(const nothing& self) {
+        return "nothing";
+    }
+
+    bool _is_(const nothing& self) {
+        return false;
+    }
+
+    double _comp_(const nothing& self, const var& n) {
+        return NOT_A_NUMBER;
+    }
+
+    void _str_(Text_Stream& out, const nothing& self) {
+        out << "nothing";
+    }
+
+    void _repr_(Text_Stream& out, const nothing& self) {
+        out << "nothing";
+    }
+
+    bool _is_nothing_(const nothing& self) {
+        return true;
+    }
+
+
+
+
+    /********************************************************************************************/
+    //
+    //                                'var' Class Implementation
+    //
+    /********************************************************************************************/
+
+    var::var() : _word(nothing_tag) {
+    }
+
+    template <typename T>
+    var::var(T x) : _word(boxed_tag) {
+
+        static_assert(sizeof(std::uintptr_t) <= sizeof(_word), "A pointer must fit within a 'var'.");
+
+        if (!encode(x, _word)) {
+
+            const std::uint64_t address = reinterpret_cast<std::uintptr_t>(data_type<T>::make(std::move(x)));
+
+            assert((address & ~payload_mask) == 0 && "A boxed address must fit within 48 bits.");
+
+            _word = boxed_tag | address;
+        }
+    }
+
+    var::var(const var& n) : _word(n._word) {
+        retain();
+    }
+
+    var::var(var&& n) noexcept : _word(n._word) {
+        n._word = nothing_tag;
+    }
+
+    var::var(const var_ref& n) : var(*n) {
+    }
+
+    var::~var() {
+        release();
+    }
+
+    var& var::operator=(const var& n) {
+        /*
+            The word is taken before releasing, since 'n' may
+            be owned by the object being released.
+        */
+
+        std::uint64_t word = n._word;
+
+        n.retain();
+
+        release();
+
+        _word = word;
+
+        return *this;
+    }
+
+    var& var::operator=(var&& n) noexcept {
+
+        std::uint64_t word = n._word;
+
+        n._word = nothing_tag;
+
+        release();
+
+        _word = word;
+
+        return *this;
+    }
+
+    template <typename T>
+    var_ptr<T> var::cast() const {
+
+        if constexpr (is_immediate<T>) {
+
+            if (holds<T>()) {
+                return decode<T>();
+            }
+
+            const T* p = boxed<T>();
+
+            if (p) {
+                return *p;
+            }
+
+            return var_ptr<T>();
+        }
+        else {
+            return boxed<T>();
+        }
+    }
+
+    template <typename T> 
+    T var::copy() const {
+
+        if constexpr (is_immediate<T>) {
+
+            if (holds<T>()) {
+                return decode<T>();
+            }
+        }
+
+        const T* p = boxed<T>();
+
+        if (p) {
+            return T{ *p };
+        }
+
+        return T{};
+    }
+
+    template <typename... Ts, typename F>
+    decltype(auto) var::visit(F&& f) const {
+        /*
+            The matching type indexes a table of calls, one for
+            each of 'Ts' followed by the call made with the 'var'.
+        */
+
+        using result_type = std::invoke_result_t<F&, const var&>;
+        using call_type   = result_type(*)(const var&, F&);
+
+        static constexpr call_type calls[] = {
+            [](const var& n, F& g) -> result_type { return g(*n.cast<Ts>()); }...,
+            [](const var& n, F& g) -> result_type { return g(n); }
+        };
+
+        std::size_t index = 0;
+
+        ((is<Ts>() || (++index, false)) || ...);
+
+        return calls[index](*this, f);
+    }
+
+    const Text& var::type() const {
+        return _interface()->_type();
+    }
+
+    const Text& var::cat() const {
+        return _interface()->_cat();
+    }
+
+    std::size_t var::type_id() const {
+
+        if (is_boxed()) {
+            return pointer()->_type_id;
+        }
+
+        if (holds<double>()) {
+            return type_registry::id<double>();
+        }
+
+        switch (_word & tag_mask) {
+
+        case bool_tag:
+            return type_registry::id<bool>();
+
+        case int_tag:
+            return type_registry::id<int>();
+
+        case long_tag:
+            return type_registry::id<long>();
+
+        default:
+            return type_registry::id<nothing>();
+        }
+    }
+
+    std::uint64_t var::capabilities() const {
+        /*
+            The capabilities of immediate values are known
+            at compile time, so they are never materialized.
+        */
+
+        if (is_boxed()) {
+            return pointer()->_ops->capabilities;
+        }
+
+        if (holds<double>()) {
+            return op_probe::capabilities<double>;
+        }
+
+        switch (_word & tag_mask) {
+
+        case bool_tag:
+            return op_probe::capabilities<bool>;
+
+        case int_tag:
+            return op_probe::capabilities<int>;
+
+        case long_tag:
+            return op_probe::capabilities<long>;
+
+        default:
+            return op_probe::capabilities<nothing>;
+        }
+    }
+
+    bool var::supports(capability op) const {
+        return (capabilities() & capability_bit(op)) != 0;
+    }
+
+    template <typename T, capability op>
+    constexpr bool var::has_override() {
+        return Olly::has_override<T, op>;
+    }
+
+    template <typename T>
+    bool var::is() const {
+
+        if constexpr (is_immediate<T>) {
+
+            if (holds<T>()) {
+                return true;
+            }
+        }
+
+        return boxed<T>() != nullptr;
+    }
+
+    bool var::is() const {
+
+        if (!supports(capability::is)) {
+            return false;  // The default '_is_'.
+        }
+
+        return _interface()->_is();
+    }
+
+    void var::str(Text_Stream& out) const {
+        _interface()->_str(out);
+    }
+
+    void var::repr(Text_Stream& out) const {
+        _interface()->_repr(out);
+    }
+
+    double var::comp(const var& n) const {
+        return _interface()->_comp(n);
+    }
+
+    bool var::equals(const var& n) const {
+        /*
+            A 'var' sharing the same boxed object is equal to
+            itself, without any call being made.  Immediate
+            values of the same type are compared directly.
+        */
+
+        if (holds<double>()) {
+            return n.holds<double>() && decode<double>() == n.decode<double>();
+        }
+
+        if (_word == n._word) {
+            return true;
+        }
+
+        if (!is_boxed()) {
+            return false;  // Immediate values never equal another type.
+        }
+
+        return pointer()->_equals(n);
+    }
+
+    std::partial_ordering var::compare(const var& n) const {
+
+        if (is_boxed()) {
+
+            if (_word == n._word) {
+                return std::partial_ordering::equivalent;
+            }
+
+            double c = pointer()->_comp(n);
+
+            if (c < 0.0) {
+                return std::partial_ordering::less;
+            }
+            if (c > 0.0) {
+                return std::partial_ordering::greater;
+            }
+            if (c == 0.0) {
+                return std::partial_ordering::equivalent;
+            }
+
+            return std::partial_ordering::unordered;
+        }
+
+        if (holds<double>() && n.holds<double>()) {
+            return decode<double>() <=> n.decode<double>();
+        }
+
+        if ((_word & tag_mask) != (n._word & tag_mask)) {
+            return std::partial_ordering::unordered;
+        }
+
+        if (holds<int>()) {
+            return decode<int>() <=> n.decode<int>();
+        }
+
+        if (holds<long>()) {
+            return decode<long>() <=> n.decode<long>();
+        }
+
+        if (holds<bool>()) {
+            return decode<bool>() <=> n.decode<bool>();
+        }
+
+        if (_word == n._word) {
+            return std::partial_ordering::equivalent;  // 'nothing' is equivalent only to itself, as it is equal.
+        }
+
+        return std::partial_ordering::unordered;
+    }
+
+    bool var::eq(const var& n) const {
+        return equals(n);
+    }
+
+    bool var::ne(const var& n) const {
+        return !equals(n);
+    }
+
+    bool var::ge(const var& n) const {
+        return compare(n) >= 0;
+    }
+
+    bool var::le(const var& n) const {
+        return compare(n) <= 0;
+    }
+
+    bool var::gt(const var& n) const {
+        return compare(n) > 0;
+    }
+
+    bool var::lt(const var& n) const {
+        return compare(n) < 0;
+    }
+
+    var var::b_and(const var& n) const {
+        return _interface()->_b_and(n);
+    }
+
+    var var::b_or(const var& n) const {
+        return _interface()->_b_or(n);
+    }
+
+    var var::b_xor(const var& n) const {
+        return _interface()->_b_xor(n);
+    }
+
+    var var::b_neg() const {
+        return _interface()->_b_neg();
+    }
+
+    var var::operator&(const var& n) const {
+        return b_and(n);
+    }
+
+    var var::operator|(const var& n) const {
+        return b_or(n);
+    }
+
+    var var::operator^(const var& n) const {
+        return b_xor(n);
+    }
+
+    var var::operator~() const {
+        return b_neg();
+    }
+
+    var var::u_add() const {
+        return _interface()->_u_add();
+    }
+
+    var var::u_neg() const {
+        return _interface()->_u_neg();
+    }
+
+    var var::add(const var& n) const {
+        return _interface()->_add(n);
+    }
+
+    var var::sub(const var& n) const {
+        return _interface()->_sub(n);
+    }
+
+    var var::mul(const var& n) const {
+        return _interface()->_mul(n);
+    }
+
+    var var::div(const var& n) const {
+        return _interface()->_div(n);
+    }
+
+    var var::mod(const var& n) const {
+        return _interface()->_mod(n);
+    }
+
+    var var::operator+() const {
+        return u_add();
+    }
+
+    var var::operator-() const {
+        return u_neg();
+    }
+
+    var var::f_div(const var& n) const {
+        return _interface()->_f_div(n);
+    }
+
+    var var::rem(const var& n) const {
+        return _interface()->_rem(n);
+    }
+
+    var var::pow(const var& n) const {
+        return _interface()->_pow(n);
+    }
+
+    var var::root(const var& n) const {
+        return _interface()->_root(n);
+    }
+
+    bool var::has(const var& n) const {
+        return _interface()->_has(n);
+    }
+
+    std::size_t var::size() const {
+
+        if (!supports(capability::size)) {
+            return 0;  // The default '_size_'.
+        }
+
+        return _interface()->_size();
+    }
+
+    var var::lead() const {
+        return _interface()->_lead();
+    }
+
+    var var::last() const {
+        return _interface()->_last();
+    }
+
+    var var::join(const var& n) const& {
+        return _interface()->_join(n);
+    }
+
+    var var::join(var&& n) const& {
+        return _interface()->_join(std::move(n));
+    }
+
+    var var::join(const var& n) && {
+        return std::move(*this).join(var(n));
+    }
+
+    var var::join(var&& n) && {
+        /*
+            An object only this 'var' references can not be seen
+            by any other, so it is changed in place rather than
+            copied, when its type allows.
+        */
+
+        auto p = owned();
+
+        if (p && p->_ops->join_in_place) {
+
+            p->_ops->join_in_place(p, std::move(n));
+
+#if defined(OLLY_CACHED_TEXT)
+            p->_reset_text();
+#endif
+            return std::move(*this);
+        }
+
+        return std::as_const(*this).join(std::move(n));
+    }
+
+    var var::link(const var& n) const& {
+        return _interface()->_link(n);
+    }
+
+    var var::link(var&& n) const& {
+        return _interface()->_link(std::move(n));
+    }
+
+    var var::link(const var& n) && {
+        return std::move(*this).link(var(n));
+    }
+
+    var var::link(var&& n) && {
+
+        auto p = owned();
+
+        if (p && p->_ops->link_in_place) {
+
+            p->_ops->link_in_place(p, std::move(n));
+
+#if defined(OLLY_CACHED_TEXT)
+            p->_reset_text();
+#endif
+            return std::move(*this);
+        }
+
+        return std::as_const(*this).link(std::move(n));
+    }
+
+    var var::next() const& {
+        return _interface()->_next();
+    }
+
+    var var::next() && {
+
+        auto p = owned();
+
+        if (p && p->_ops->next_in_place) {
+
+            p->_ops->next_in_place(p);
+
+#if defined(OLLY_CACHED_TEXT)
+            p->_reset_text();
+#endif
+            return std::move(*this);
+        }
+
+        return std::as_const(*this).next();
+    }
+
+    var var::prev() const& {
+        return _interface()->_prev();
+    }
+
+    var var::prev() && {
+
+        auto p = owned();
+
+        if (p && p->_ops->prev_in_place) {
+
+            p->_ops->prev_in_place(p);
+
+#if defined(OLLY_CACHED_TEXT)
+            p->_reset_text();
+#endif
+            return std::move(*this);
+        }
+
+        return std::as_const(*this).prev();
+    }
+
+    var var::drop(std::size_t n) const {
+        /*
+            Types which cannot drop elements at once
+            drop each in turn.
+        */
+
+        if (supports(capability::drop)) {
+            return _interface()->_drop(n);
+        }
+
+        var a{ *this };
+
+        while (n--) {
+
+            a = a.next();
+        }
+
+        return a;
+    }
+
+    var var::take(std::size_t n) const {
+
+        if (supports(capability::take)) {
+            return _interface()->_take(n);
+        }
+
+        var a{ *this };
+
+        for (std::size_t size = a.size(); size > n; --size) {
+            a = a.prev();
+        }
+
+        return a;
+    }
+
+    var var::operator>>(std::size_t shift) const {
+        return drop(shift);
+    }
+
+    var var::operator<<(std::size_t shift) const {
+
+        if (supports(capability::take)) {
+
+            const std::size_t n = size();
+
+            return take(shift < n ? n - shift : 0);
+        }
+
+        var a{ *this };
+
+        while (shift--) {
             a = a.prev();
         }
 
-        return a;
-    }
+        return a;
+    }
+
+    var var::operator,(const var& n) const& {
+        return link(n);
+    }
+
+    var var::operator,(var&& n) const& {
+        return link(std::move(n));
+    }
+
+    var var::operator,(const var& n) && {
+        return std::move(*this).link(n);
+    }
+
+    var var::operator,(var&& n) && {
+        return std::move(*this).link(std::move(n));
+    }
+
+    var var::reverse() const {
+        return _interface()->_reverse();
+    }
+
+    var var::get(const var& n) const {
+        return _interface()->_get(n);
+    }
+
+    var var::set(const var& n, const var& val) const {
+        return _interface()->_set(n, val);
+    }
+
+    var var::set(const var& n, var&& val) const {
+        return _interface()->_set(n, std::move(val));
+    }
+
+    var var::del(const var& n) const {
+        return _interface()->_del(n);
+    }
+
+    std::size_t var::hash() const {
+        /*
+            Immediate values are hashed without materializing them.
+        */
+
+        if (is_boxed()) {
+            return pointer()->_hash();
+        }
+
+        if (holds<double>()) {
+            return hash_value(decode<double>());
+        }
+
+        switch (_word & tag_mask) {
+
+        case bool_tag:
+            return hash_value(decode<bool>());
+
+        case int_tag:
+            return hash_value(decode<int>());
+
+        case long_tag:
+            return hash_value(decode<long>());
+
+        default:
+            return nothing_interface()->_hash();
+        }
+    }
+
+    OP_CODE var::op_code() const {
+        return _interface()->_op_code();
+    }
+
+    bool var::is_nothing() const {
+
+        if (holds<nothing>()) {
+            return true;
+        }
+
+        return is_boxed() && supports(capability::is_nothing) && _interface()->_is_nothing();
+    }
+
+    bool var::is_something() const {
+        return !is_nothing();
+    }
+
+    bool var::unique() const {
+        /*
+            Immediate values are copied rather than shared,
+            so a 'var' holding one is always unique.
+        */
+
+        return !is_boxed() || pointer()->_count.unique();
+    }
+
+    Text var::help() const {
+        return _interface()->_help();
+    }
+
+    var::operator bool() const {
+        return is();
+    }
+
+    bool var::operator==(const var& n) const {
+        return eq(n);
+    }
+
+    bool var::operator!=(const var& n) const {
+        return ne(n);
+    }
+
+    bool var::operator>=(const var& n) const {
+        return ge(n);
+    }
+
+    bool var::operator> (const var& n) const {
+        return gt(n);
+    }
+
+    bool var::operator<=(const var& n) const {
+        return le(n);
+    }
+
+    bool var::operator< (const var& n) const {
+        return lt(n);
+    }
+
+    var var::operator+(const var& n) const {
+        return add(n);
+    }
+
+    var var::operator-(const var& n) const {
+        return sub(n);
+    }
+
+    var var::operator*(const var& n) const {
+        return mul(n);
+    }
+
+    var var::operator/(const var& n) const {
+        return div(n);
+    }
+
+    var var::operator%(const var& n) const {
+        return mod(n);
+    }
+
+
+
+
+    /********************************************************************************************/
+    //
+    //                                'var_ref' Class Implementation
+    //
+    /********************************************************************************************/
+
+    var_ref::var_ref(const var& n) : _var(&n) {
+    }
+
+    const var& var_ref::operator*() const {
+        return *_var;
+    }
+
+    const var* var_ref::operator->() const {
+        return _var;
+    }
+
+    var_ref::operator const var&() const {
+        return *_var;
+    }
+
+
+
+
+    /********************************************************************************************/
+    //
+    //                                'var_ptr' Class Implementation
+    //
+    /********************************************************************************************/
+
+    template <typename T>
+    var_ptr<T, false>::var_ptr(const T* ptr) : _ptr(ptr) {
+    }
+
+    template <typename T>
+    const T* var_ptr<T, false>::get() const {
+        return _ptr;
+    }
+
+    template <typename T>
+    const T& var_ptr<T, false>::operator*() const {
+        return *_ptr;
+    }
+
+    template <typename T>
+    const T* var_ptr<T, false>::operator->() const {
+        return _ptr;
+    }
+
+    template <typename T>
+    var_ptr<T, false>::operator bool() const {
+        return _ptr != nullptr;
+    }
+
+    template <typename T>
+    var_ptr<T, true>::var_ptr() : _value(), _valid(false) {
+    }
+
+    template <typename T>
+    var_ptr<T, true>::var_ptr(T value) : _value(value), _valid(true) {
+    }
+
+    template <typename T>
+    const T* var_ptr<T, true>::get() const {
+        return _valid ? &_value : nullptr;
+    }
+
+    template <typename T>
+    const T& var_ptr<T, true>::operator*() const {
+        return _value;
+    }
+
+    template <typename T>
+    const T* var_ptr<T, true>::operator->() const {
+        return get();
+    }
+
+    template <typename T>
+    var_ptr<T, true>::operator bool() const {
+        return _valid;
+    }
+
+
+
+
+    /********************************************************************************************/
+    //
+    //                              'interface_type' Class Implementation
+    //
+    /********************************************************************************************/
+
+    var::interface_type::operator bool() const {
+        return _ops->is(this);
+    }
+    const Text& var::interface_type::_type() const {
+        return _ops->type(this);
+    }
+    const Text& var::interface_type::_cat() const {
+        return _ops->cat(this);
+    }
+    bool var::interface_type::_is() const {
+        return _ops->is(this);
+    }
+#if defined(OLLY_CACHED_TEXT)
+    void var::interface_type::_free_text() const {
+        /*
+            Called as the object is destroyed, rather than from
+            a destructor, so immediate values materialized on the
+            stack remain trivially destructible.
+        */
+
+        delete _str_text.load(std::memory_order_acquire);
+        delete _repr_text.load(std::memory_order_acquire);
+    }
+
+    void var::interface_type::_reset_text() const {
+        delete _str_text.exchange(nullptr, std::memory_order_acq_rel);
+        delete _repr_text.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    void var::interface_type::_write_cached(std::atomic<const Text*>& text, Text_Stream& out, std::size_t max_size,
+                                            void (*render)(const interface_type* p, Text_Stream& out)) const {
+        /*
+            Only text in the standard format is cached.  The
+            text rendered is read back from the writer, unless
+            it was handed to a sink.  Threads racing to fill
+            the cache keep the first text stored.
+        */
+
+        if (!out.standard_format()) {
+            render(this, out);
+            return;
+        }
+
+        const Text* cached = text.load(std::memory_order_acquire);
+
+        if (cached) {
+
+#if defined(OLLY_INSTRUMENTATION)
+            text_cache_stats::hit();
+#endif
+            out << *cached;
+
+            return;
+        }
+
+#if defined(OLLY_INSTRUMENTATION)
+        text_cache_stats::missed();
+#endif
+
+        if (out.streaming()) {
+            render(this, out);
+            return;
+        }
+
+        const std::size_t start = out.size();
+
+        render(this, out);
+
+        if (out.size() - start > max_size) {
+            return;
+        }
+
+        const Text* rendered = new Text(out.view().substr(start));
+        const Text* expected = nullptr;
+
+        if (!text.compare_exchange_strong(expected, rendered, std::memory_order_acq_rel)) {
+            delete rendered;
+        }
+    }
+#endif
+
+    void var::interface_type::_str(Text_Stream& out) const {
+        _ops->str(this, out);
+    }
+    void var::interface_type::_repr(Text_Stream& out) const {
+        _ops->repr(this, out);
+    }
+    double var::interface_type::_comp(const var& n) const {
+        return _ops->comp(this, n);
+    }
+
+    bool var::interface_type::_equals(const var& n) const {
+        return _ops->equals(this, n);
+    }
+    var var::interface_type::_b_and(const var& n) const {
+        return _ops->b_and(this, n);
+    }
+    var var::interface_type::_b_or(const var& n) const {
+        return _ops->b_or(this, n);
+    }
+    var var::interface_type::_b_xor(const var& n) const {
+        return _ops->b_xor(this, n);
+    }
+    var var::interface_type::_b_neg() const {
+        return _ops->b_neg(this);
+    }
+    var var::interface_type::_u_add() const {
+        return _ops->u_add(this);
+    }
+    var var::interface_type::_u_neg() const {
+        return _ops->u_neg(this);
+    }
+    var var::interface_type::_add(const var& n) const {
+        return _ops->add(this, n);
+    }
+    var var::interface_type::_sub(const var& n) const {
+        return _ops->sub(this, n);
+    }
+    var var::interface_type::_mul(const var& n) const {
+        return _ops->mul(this, n);
+    }
+    var var::interface_type::_div(const var& n) const {
+        return _ops->div(this, n);
+    }
+    var var::interface_type::_mod(const var& n) const {
+        return _ops->mod(this, n);
+    }
+    var var::interface_type::_f_div(const var& n) const {
+        return _ops->f_div(this, n);
+    }
+    var var::interface_type::_rem(const var& n) const {
+        return _ops->rem(this, n);
+    }
+    var var::interface_type::_pow(const var& n) const {
+        return _ops->pow(this, n);
+    }
+    var var::interface_type::_root(const var& n) const {
+        return _ops->root(this, n);
+    }
+    bool var::interface_type::_has(const var& n) const {
+        return _ops->has(this, n);
+    }
+    std::size_t var::interface_type::_size() const {
+        return _ops->size(this);
+    }
+    var var::interface_type::_lead() const {
+        return _ops->lead(this);
+    }
+    var var::interface_type::_last() const {
+        return _ops->last(this);
+    }
+    var var::interface_type::_join(const var& n) const {
+        return _ops->join(this, n);
+    }
+    var var::interface_type::_join(var&& n) const {
+        return _ops->join_move(this, std::move(n));
+    }
+    var var::interface_type::_link(const var& n) const {
+        return _ops->link(this, n);
+    }
+    var var::interface_type::_link(var&& n) const {
+        return _ops->link_move(this, std::move(n));
+    }
+    var var::interface_type::_next() const {
+        return _ops->next(this);
+    }
+    var var::interface_type::_prev() const {
+        return _ops->prev(this);
+    }
+    var var::interface_type::_drop(std::size_t n) const {
+        return _ops->drop(this, n);
+    }
+    var var::interface_type::_take(std::size_t n) const {
+        return _ops->take(this, n);
+    }
+    var var::interface_type::_reverse() const {
+        return _ops->reverse(this);
+    }
+    var var::interface_type::_get(const var& key) const {
+        return _ops->get(this, key);
+    }
+    var var::interface_type::_set(const var& key, const var& val) const {
+        return _ops->set(this, key, val);
+    }
+    var var::interface_type::_set(const var& key, var&& val) const {
+        return _ops->set_move(this, key, std::move(val));
+    }
+    var var::interface_type::_del(const var& key) const {
+        return _ops->del(this, key);
+    }
+    std::size_t var::interface_type::_hash() const {
+        return _ops->hash(this);
+    }
+    Text var::interface_type::_help() const {
+        return _ops->help(this);
+    }
+    bool var::interface_type::_is_nothing() const {
+        return _ops->is_nothing(this);
+    }
+    OP_CODE var::interface_type::_op_code() const {
+        return _ops->op_code(this);
+    }
+
+
+
+    /********************************************************************************************/
+    //
+    //                               'default_type' Class Implementation
+    //
+    /********************************************************************************************/
+
+    constexpr var::operations var::default_type::table() {
+
+        /*
+            The operations which depend upon the type
+            are left null, to be set by each 'data_type'.
+        */
+
+        operations ops{};
+
+        ops.cat        = &cat;
+        ops.is         = &is;
+        ops.repr       = &repr;
+        ops.comp       = &comp;
+        ops.equals     = &equals;
+        ops.b_and      = &b_and;
+        ops.b_or       = &b_or;
+        ops.b_xor      = &b_xor;
+        ops.u_add      = &u_add;
+        ops.u_neg      = &u_neg;
+        ops.add        = &add;
+        ops.sub        = &sub;
+        ops.mul        = &mul;
+        ops.div        = &div;
+        ops.mod        = &mod;
+        ops.f_div      = &f_div;
+        ops.rem        = &rem;
+        ops.pow        = &pow;
+        ops.root       = &root;
+        ops.has        = &has;
+        ops.size       = &size;
+        ops.lead       = &lead;
+        ops.last       = &last;
+        ops.join       = &join;
+        ops.join_move  = &join_move;
+        ops.link       = &link;
+        ops.link_move  = &link_move;
+        ops.next       = &next;
+        ops.prev       = &prev;
+        ops.drop       = &drop;
+        ops.take       = &take;
+        ops.reverse    = &reverse;
+        ops.get        = &get;
+        ops.set        = &set;
+        ops.set_move   = &set_move;
+        ops.del        = &del;
+        ops.help       = &help;
+        ops.is_nothing = &is_nothing;
+        ops.op_code    = &op_code;
+
+        return ops;
+    }
+
+    const Text& var::default_type::cat(const interface_type* p) {
+
+        static const Text& name = type_registry::intern(_cat_<interface_type>(*p));
+
+        return name;
+    }
+
+    bool var::default_type::is(const interface_type* p) {
+        return _is_<interface_type>(*p);
+    }
+
+    void var::default_type::repr(const interface_type* p, Text_Stream& out) {
+        _repr_<interface_type>(out, *p);
+    }
+
+    double var::default_type::comp(const interface_type* p, const var& n) {
+        return _comp_<interface_type>(*p, n);
+    }
+
+    bool var::default_type::equals(const interface_type* p, const var& n) {
+        /*
+            The default equality depends upon the comparison
+            of the type, so the call is made on its own table.
+        */
+
+        return p->_ops->comp(p, n) == 0.0;
+    }
+
+    var var::default_type::b_and(const interface_type* p, const var& n) {
+        return _b_and_<interface_type>(*p, n);
+    }
+
+    var var::default_type::b_or(const interface_type* p, const var& n) {
+        return _b_or_<interface_type>(*p, n);
+    }
+
+    var var::default_type::b_xor(const interface_type* p, const var& n) {
+        return _b_xor_<interface_type>(*p, n);
+    }
+
+    var var::default_type::u_add(const interface_type* p) {
+        return _u_add_<interface_type>(*p);
+    }
+
+    var var::default_type::u_neg(const interface_type* p) {
+        return _u_neg_<interface_type>(*p);
+    }
+
+    var var::default_type::add(const interface_type* p, const var& n) {
+        return _add_<interface_type>(*p, n);
+    }
+
+    var var::default_type::sub(const interface_type* p, const var& n) {
+        return _sub_<interface_type>(*p, n);
+    }
+
+    var var::default_type::mul(const interface_type* p, const var& n) {
+        return _mul_<interface_type>(*p, n);
+    }
+
+    var var::default_type::div(const interface_type* p, const var& n) {
+        return _div_<interface_type>(*p, n);
+    }
+
+    var var::default_type::mod(const interface_type* p, const var& n) {
+        return _mod_<interface_type>(*p, n);
+    }
+
+    var var::default_type::f_div(const interface_type* p, const var& n) {
+        return _f_div_<interface_type>(*p, n);
+    }
+
+    var var::default_type::rem(const interface_type* p, const var& n) {
+        return _rem_<interface_type>(*p, n);
+    }
+
+    var var::default_type::pow(const interface_type* p, const var& n) {
+        return _pow_<interface_type>(*p, n);
+    }
+
+    var var::default_type::root(const interface_type* p, const var& n) {
+        return _root_<interface_type>(*p, n);
+    }
+
+    bool var::default_type::has(const interface_type* p, const var& n) {
+        return _has_<interface_type>(*p, n);
+    }
+
+    std::size_t var::default_type::size(const interface_type* p) {
+        return _size_<interface_type>(*p);
+    }
+
+    var var::default_type::lead(const interface_type* p) {
+        return _lead_<interface_type>(*p);
+    }
+
+    var var::default_type::last(const interface_type* p) {
+        return _last_<interface_type>(*p);
+    }
+
+    var var::default_type::join(const interface_type* p, const var& n) {
+        return _join_<interface_type>(*p, n);
+    }
+
+    var var::default_type::join_move(const interface_type* p, var&& n) {
+        /*
+            The default moves nothing, so the call is
+            made on the type's own copying operation.
+        */
+
+        return p->_ops->join(p, n);
+    }
+
+    var var::default_type::link(const interface_type* p, const var& n) {
+        return _link_<interface_type>(*p, n);
+    }
+
+    var var::default_type::link_move(const interface_type* p, var&& n) {
+        /*
+            The default moves nothing, so the call is
+            made on the type's own copying operation.
+        */
+
+        return p->_ops->link(p, n);
+    }
+
+    var var::default_type::next(const interface_type* p) {
+        return _next_<interface_type>(*p);
+    }
+
+    var var::default_type::prev(const interface_type* p) {
+        return _prev_<interface_type>(*p);
+    }
+
+    var var::default_type::drop(const interface_type* p, std::size_t n) {
+        return _drop_<interface_type>(*p, n);
+    }
+
+    var var::default_type::take(const interface_type* p, std::size_t n) {
+        return _take_<interface_type>(*p, n);
+    }
+
+    var var::default_type::reverse(const interface_type* p) {
+        return _reverse_<interface_type>(*p);
+    }
+
+    var var::default_type::get(const interface_type* p, const var& key) {
+        return _get_<interface_type>(*p, key);
+    }
+
+    var var::default_type::set(const interface_type* p, const var& key, const var& val) {
+        return _set_<interface_type>(*p, key, val);
+    }
+
+    var var::default_type::set_move(const interface_type* p, const var& key, var&& val) {
+        /*
+            The default moves nothing, so the call is
+            made on the type's own copying operation.
+        */
+
+        return p->_ops->set(p, key, val);
+    }
+
+    var var::default_type::del(const interface_type* p, const var& key) {
+        return _del_<interface_type>(*p, key);
+    }
+
+    Text var::default_type::help(const interface_type* p) {
+        return _help_<interface_type>(*p);
+    }
+
+    bool var::default_type::is_nothing(const interface_type* p) {
+        return _is_nothing_<interface_type>(*p);
+    }
+
+    OP_CODE var::default_type::op_code(const interface_type* p) {
+        return _op_code_<interface_type>(*p);
+    }
+
+
+
+
+    /********************************************************************************************/
+    //
+    //                                'data_type' Class Implementation
+    //
+    /********************************************************************************************/
+
+    template <typename T>
+    var::data_type<T>::data_type(T val) : interface_type(type_registry::id<T>(), &table), _data(std::move(val)) {
+    }
+
+    template <typename T>
+    const var::operations var::data_type<T>::table = make_table();
+
+    template <typename T>
+    constexpr var::operations var::data_type<T>::make_table() {
+        /*
+            Begin with the shared defaults, then replace each
+            operation the type overrides, and each operation
+            whose default depends upon the type.
+        */
+
+        operations ops = default_type::table();
+
+        ops.capabilities = op_probe::capabilities<T>;
+        ops.destroy      = &destroy;
+        ops.type         = &type;
+        ops.str          = &str;
+        ops.b_neg        = &b_neg;
+        ops.hash         = &hash;
+
+        if constexpr (op_probe::cat<T>) {
+            ops.cat = &cat;
+        }
+
+        if constexpr (op_probe::is<T>) {
+            ops.is = &is;
+        }
+
+        if constexpr (op_probe::repr<T>) {
+            ops.repr = &repr;
+        }
+
+        if constexpr (op_probe::comp<T>) {
+            ops.comp = &comp;
+        }
+
+        if constexpr (op_probe::equals<T>) {
+            ops.equals = &equals;
+        }
+
+        if constexpr (op_probe::b_and<T>) {
+            ops.b_and = &b_and;
+        }
+
+        if constexpr (op_probe::b_or<T>) {
+            ops.b_or = &b_or;
+        }
+
+        if constexpr (op_probe::b_xor<T>) {
+            ops.b_xor = &b_xor;
+        }
+
+        if constexpr (op_probe::u_add<T>) {
+            ops.u_add = &u_add;
+        }
+
+        if constexpr (op_probe::u_neg<T>) {
+            ops.u_neg = &u_neg;
+        }
+
+        if constexpr (op_probe::add<T>) {
+            ops.add = &add;
+        }
+
+        if constexpr (op_probe::sub<T>) {
+            ops.sub = &sub;
+        }
+
+        if constexpr (op_probe::mul<T>) {
+            ops.mul = &mul;
+        }
+
+        if constexpr (op_probe::div<T>) {
+            ops.div = &div;
+        }
+
+        if constexpr (op_probe::mod<T>) {
+            ops.mod = &mod;
+        }
+
+        if constexpr (op_probe::f_div<T>) {
+            ops.f_div = &f_div;
+        }
+
+        if constexpr (op_probe::rem<T>) {
+            ops.rem = &rem;
+        }
+
+        if constexpr (op_probe::pow<T>) {
+            ops.pow = &pow;
+        }
+
+        if constexpr (op_probe::root<T>) {
+            ops.root = &root;
+        }
+
+        if constexpr (op_probe::has<T>) {
+            ops.has = &has;
+        }
+
+        if constexpr (op_probe::size<T>) {
+            ops.size = &size;
+        }
+
+        if constexpr (op_probe::lead<T>) {
+            ops.lead = &lead;
+        }
+
+        if constexpr (op_probe::last<T>) {
+            ops.last = &last;
+        }
+
+        if constexpr (op_probe::join<T>) {
+            ops.join = &join;
+        }
+
+        if constexpr (op_probe::join_move<T>) {
+            ops.join_move = &join_move;
+        }
+
+        if constexpr (op_probe::link<T>) {
+            ops.link = &link;
+        }
+
+        if constexpr (op_probe::link_move<T>) {
+            ops.link_move = &link_move;
+        }
+
+        if constexpr (op_probe::next<T>) {
+            ops.next = &next;
+        }
+
+        if constexpr (op_probe::prev<T>) {
+            ops.prev = &prev;
+        }
+
+        if constexpr (op_probe::join_in_place<T>) {
+            ops.join_in_place = &join_in_place;
+        }
+
+        if constexpr (op_probe::link_in_place<T>) {
+            ops.link_in_place = &link_in_place;
+        }
+
+        if constexpr (op_probe::next_in_place<T>) {
+            ops.next_in_place = &next_in_place;
+        }
+
+        if constexpr (op_probe::prev_in_place<T>) {
+            ops.prev_in_place = &prev_in_place;
+        }
+
+        if constexpr (op_probe::drop<T>) {
+            ops.drop = &drop;
+        }
+
+        if constexpr (op_probe::take<T>) {
+            ops.take = &take;
+        }
 
-    var var::operator,(var n) const {
-        return link(n);
-    }
+        if constexpr (op_probe::reverse<T>) {
+            ops.reverse = &reverse;
+        }
 
-    var var::reverse() const {
-        return _ptr->_reverse();
-    }
+        if constexpr (op_probe::get<T>) {
+            ops.get = &get;
+        }
 
-    var var::get(var n) const {
-        return _ptr->_get(n);
-    }
+        if constexpr (op_probe::set<T>) {
+            ops.set = &set;
+        }
 
-    var var::set(var n, var val) const {
-        return _ptr->_set(n, val);
-    }
+        if constexpr (op_probe::set_move<T>) {
+            ops.set_move = &set_move;
+        }
 
-    var var::del(var n) const {
-        return _ptr->_del(n);
-    }
+        if constexpr (op_probe::del<T>) {
+            ops.del = &del;
+        }
 
-    std::size_t var::hash() const {
-        return _ptr->_hash();
-    }
+        if constexpr (op_probe::help<T>) {
+            ops.help = &help;
+        }
 
-    OP_CODE var::op_code() const {
-        return _ptr->_op_code();
-    }
+        if constexpr (op_probe::is_nothing<T>) {
+            ops.is_nothing = &is_nothing;
+        }
 
-    bool var::is_nothing() const {
-        return _ptr->_is_nothing();
-    }
+        if constexpr (op_probe::op_code<T>) {
+            ops.op_code = &op_code;
+        }
 
-    bool var::is_something() const {
-        return !_ptr->_is_nothing();
+        return ops;
     }
 
-    Text var::help() const {
-        return _ptr->_help();
-    }
+    template <typename T>
+    var::data_type<T>* var::data_type<T>::make(T val) {
 
-    var::operator bool() const {
-        return is();
+        data_type* object;
+
+#if defined(OLLY_DEFAULT_ALLOCATOR)
+        object = new data_type(std::move(val));
+#else
+        void* block = block_pool::allocate(sizeof(data_type), alignof(data_type));
+
+        try {
+            object = new (block) data_type(std::move(val));
+        }
+        catch (...) {
+            block_pool::deallocate(block, sizeof(data_type), alignof(data_type));
+            throw;
+        }
+#endif
+
+#if defined(OLLY_INSTRUMENTATION)
+        allocation_stats::allocated(allocations(object));
+#endif
+
+        return object;
     }
 
-    bool var::operator==(var n) const {
-        return eq(n);
+#if defined(OLLY_INSTRUMENTATION)
+    template <typename T>
+    allocation_stats::counters& var::data_type<T>::allocations(const interface_type* p) {
+
+        static allocation_stats::counters& counters = allocation_stats::track(type_registry::id<T>(), type(p), sizeof(data_type));
+
+        return counters;
     }
+#endif
 
-    bool var::operator!=(var n) const {
-        return ne(n);
+    template <typename T>
+    const T& var::data_type<T>::self(const interface_type* p) {
+        return static_cast<const data_type*>(p)->_data;
     }
 
-    bool var::operator>=(var n) const {
-        return ge(n);
+    template <typename T>
+    T& var::data_type<T>::owned(interface_type* p) {
+        return static_cast<data_type*>(p)->_data;
     }
 
-    bool var::operator> (var n) const {
-        return gt(n);
+    template <typename T>
+    void var::data_type<T>::destroy(const interface_type* p) {
+
+#if defined(OLLY_CACHED_TEXT)
+        p->_free_text();
+#endif
+
+#if defined(OLLY_INSTRUMENTATION)
+        allocation_stats::freed(allocations(p));
+#endif
+
+#if defined(OLLY_DEFAULT_ALLOCATOR)
+        delete static_cast<const data_type*>(p);
+#else
+        data_type* object = const_cast<data_type*>(static_cast<const data_type*>(p));
+
+        object->~data_type();
+
+        block_pool::deallocate(object, sizeof(data_type), alignof(data_type));
+#endif
     }
 
-    bool var::operator<=(var n) const {
-        return le(n);
+    template <typename T>
+    const Text& var::data_type<T>::type(const interface_type* p) {
+
+        static const Text& name = type_registry::intern(_type_(self(p)));
+
+        return name;
     }
 
-    bool var::operator< (var n) const {
-        return lt(n);
+    template <typename T>
+    const Text& var::data_type<T>::cat(const interface_type* p) {
+
+        static const Text& name = type_registry::intern(_cat_(self(p)));
+
+        return name;
     }
 
-    var var::operator+(var n) const {
-        return add(n);
+    template <typename T>
+    bool var::data_type<T>::is(const interface_type* p) {
+        return _is_(self(p));
     }
 
-    var var::operator-(var n) const {
-        return sub(n);
+    template <typename T>
+    void var::data_type<T>::str(const interface_type* p, Text_Stream& out) {
+
+#if defined(OLLY_CACHED_TEXT)
+        if constexpr (text_cache_policy<T>::str && !is_immediate_type<T>) {
+
+            p->_write_cached(p->_str_text, out, text_cache_policy<T>::max_size, [](const interface_type* q, Text_Stream& o) {
+                _str_(o, self(q));
+            });
+
+            return;
+        }
+#endif
+
+        _str_(out, self(p));
     }
 
-    var var::operator*(var n) const {
-        return mul(n);
+    template <typename T>
+    void var::data_type<T>::repr(const interface_type* p, Text_Stream& out) {
+
+#if defined(OLLY_CACHED_TEXT)
+        if constexpr (text_cache_policy<T>::repr && !is_immediate_type<T>) {
+
+            p->_write_cached(p->_repr_text, out, text_cache_policy<T>::max_size, [](const interface_type* q, Text_Stream& o) {
+                _repr_(o, self(q));
+            });
+
+            return;
+        }
+#endif
+
+        _repr_(out, self(p));
     }
 
-    var var::operator/(var n) const {
-        return div(n);
+    template <typename T>
+    double var::data_type<T>::comp(const interface_type* p, const var& n) {
+        return _comp_(self(p), n);
     }
 
-    var var::operator%(var n) const {
-        return mod(n);
+    template <typename T>
+    bool var::data_type<T>::equals(const interface_type* p, const var& n) {
+        return _equals_(self(p), n);
     }
 
+    template <typename T>
+    var var::data_type<T>::b_and(const interface_type* p, const var& n) {
+        return _b_and_(self(p), n);
+    }
 
+    template <typename T>
+    var var::data_type<T>::b_or(const interface_type* p, const var& n) {
+        return _b_or_(self(p), n);
+    }
 
+    template <typename T>
+    var var::data_type<T>::b_xor(const interface_type* p, const var& n) {
+        return _b_xor_(self(p), n);
+    }
 
-    /********************************************************************************************/
-    //
-    //                                'data_type' Class Implementation
-    //
-    /********************************************************************************************/
+    template <typename T>
+    var var::data_type<T>::b_neg(const interface_type* p) {
+        return _b_neg_(self(p));
+    }
 
     template <typename T>
-    var::data_type<T>::data_type(T val) : _data(std::move(val)) {
+    var var::data_type<T>::u_add(const interface_type* p) {
+        return _u_add_(self(p));
     }
 
-    template<typename T>
-    var::data_type<T>::~data_type() {
+    template <typename T>
+    var var::data_type<T>::u_neg(const interface_type* p) {
+        return _u_neg_(self(p));
     }
 
     template <typename T>
-    var::data_type<T>::operator bool() const {
-        return _is();
+    var var::data_type<T>::add(const interface_type* p, const var& n) {
+        return _add_(self(p), n);
     }
 
     template <typename T>
-    std::size_t var::data_type<T>::_hash() const {
-        return _hash_(_data);
+    var var::data_type<T>::sub(const interface_type* p, const var& n) {
+        return _sub_(self(p), n);
     }
 
     template <typename T>
-    Text var::data_type<T>::_type() const {
-        return _type_(_data);
+    var var::data_type<T>::mul(const interface_type* p, const var& n) {
+        return _mul_(self(p), n);
     }
 
     template <typename T>
-    Text var::data_type<T>::_cat() const {
-        return _cat_(_data);
+    var var::data_type<T>::div(const interface_type* p, const var& n) {
+        return _div_(self(p), n);
     }
 
     template <typename T>
-    bool var::data_type<T>::_is() const {
-        return _is_(_data);
+    var var::data_type<T>::mod(const interface_type* p, const var& n) {
+        return _mod_(self(p), n);
     }
 
     template <typename T>
-    void var::data_type<T>::_str(Text_Stream& out) const {
-        _str_(out, _data);
+    var var::data_type<T>::f_div(const interface_type* p, const var& n) {
+        return _f_div_(self(p), n);
     }
 
     template <typename T>
-    void var::data_type<T>::_repr(Text_Stream& out) const {
-        _repr_(out, _data);
+    var var::data_type<T>::rem(const interface_type* p, const var& n) {
+        return _rem_(self(p), n);
     }
 
     template <typename T>
-    double var::data_type<T>::_comp(var n) const {
-        return _comp_(_data, n);
+    var var::data_type<T>::pow(const interface_type* p, const var& n) {
+        return _pow_(self(p), n);
     }
 
     template <typename T>
-    var var::data_type<T>::_b_and(var n) const {
-        return _b_and_(_data, n);
+    var var::data_type<T>::root(const interface_type* p, const var& n) {
+        return _root_(self(p), n);
     }
 
     template <typename T>
-    var var::data_type<T>::_b_or(var n) const {
-        return _b_or_(_data, n);
+    bool var::data_type<T>::has(const interface_type* p, const var& n) {
+        return _has_(self(p), n);
     }
 
     template <typename T>
-    var var::data_type<T>::_b_xor(var n) const {
-        return _b_xor_(_data, n);
+    std::size_t var::data_type<T>::size(const interface_type* p) {
+        return _size_(self(p));
     }
 
     template <typename T>
-    var var::data_type<T>::_b_neg() const {
-        return _b_neg_(_data);
+    var var::data_type<T>::lead(const interface_type* p) {
+        return _lead_(self(p));
     }
 
-    template<typename T>
-    inline var var::data_type<T>::_u_add() const {
-        return _u_add_(_data);
+    template <typename T>
+    var var::data_type<T>::last(const interface_type* p) {
+        return _last_(self(p));
     }
 
-    template<typename T>
-    inline var var::data_type<T>::_u_neg() const {
-        return _u_neg_(_data);
+    template <typename T>
+    var var::data_type<T>::join(const interface_type* p, const var& n) {
+        return _join_(self(p), n);
     }
 
     template <typename T>
-    var var::data_type<T>::_add(var n) const {
-        return _add_(_data, n);
+    var var::data_type<T>::join_move(const interface_type* p, var&& n) {
+        return _join_(self(p), std::move(n));
     }
 
     template <typename T>
-    var var::data_type<T>::_sub(var n) const {
-        return _sub_(_data, n);
+    var var::data_type<T>::link(const interface_type* p, const var& n) {
+        return _link_(self(p), n);
     }
 
     template <typename T>
-    var var::data_type<T>::_mul(var n) const {
-        return _mul_(_data, n);
+    var var::data_type<T>::link_move(const interface_type* p, var&& n) {
+        return _link_(self(p), std::move(n));
     }
 
     template <typename T>
-    var var::data_type<T>::_div(var n) const {
-        return _div_(_data, n);
+    var var::data_type<T>::next(const interface_type* p) {
+        return _next_(self(p));
     }
 
     template <typename T>
-    var var::data_type<T>::_mod(var n) const {
-        return _mod_(_data, n);
+    var var::data_type<T>::prev(const interface_type* p) {
+        return _prev_(self(p));
     }
 
     template <typename T>
-    var var::data_type<T>::_f_div(var n) const {
-        return _f_div_(_data, n);
+    var var::data_type<T>::drop(const interface_type* p, std::size_t n) {
+        return _drop_(self(p), n);
     }
 
     template <typename T>
-    var var::data_type<T>::_rem(var n) const {
-        return _rem_(_data, n);
+    var var::data_type<T>::take(const interface_type* p, std::size_t n) {
+        return _take_(self(p), n);
     }
 
     template <typename T>
-    var var::data_type<T>::_pow(var n) const {
-        return _pow_(_data, n);
+    void var::data_type<T>::join_in_place(interface_type* p, var&& n) {
+        _join_(owned(p), std::move(n));
     }
 
     template <typename T>
-    var var::data_type<T>::_root(var n) const {
-        return _root_(_data, n);
+    void var::data_type<T>::link_in_place(interface_type* p, var&& n) {
+        _link_(owned(p), std::move(n));
     }
 
     template <typename T>
-    bool var::data_type<T>::_has(var n) const {
-        return _has_(_data, n);
+    void var::data_type<T>::next_in_place(interface_type* p) {
+        _next_(owned(p));
     }
 
     template <typename T>
-    std::size_t var::data_type<T>::_size() const {
-        return _size_(_data);
+    void var::data_type<T>::prev_in_place(interface_type* p) {
+        _prev_(owned(p));
     }
 
     template <typename T>
-    var var::data_type<T>::_lead() const {
-        return _lead_(_data);
+    var var::data_type<T>::reverse(const interface_type* p) {
+        return _reverse_(self(p));
     }
 
     template <typename T>
-    var var::data_type<T>::_last() const {
-        return _last_(_data);
+    var var::data_type<T>::get(const interface_type* p, const var& key) {
+        return _get_(self(p), key);
     }
 
     template <typename T>
-    var var::data_type<T>::_join(var n) const {
-        return _join_(_data, n);
+    var var::data_type<T>::set(const interface_type* p, const var& key, const var& val) {
+        return _set_(self(p), key, val);
     }
 
     template <typename T>
-    var var::data_type<T>::_link(var n) const {
-        return _link_(_data, n);
+    var var::data_type<T>::set_move(const interface_type* p, const var& key, var&& val) {
+        return _set_(self(p), key, std::move(val));
     }
 
     template <typename T>
-    var var::data_type<T>::_next() const {
-        return _next_(_data);
+    var var::data_type<T>::del(const interface_type* p, const var& key) {
+        return _del_(self(p), key);
     }
 
     template <typename T>
-    var var::data_type<T>::_prev() const {
-        return _prev_(_data);
+    std::size_t var::data_type<T>::hash(const interface_type* p) {
+        /*
+            The default '_hash_' hashes arithmetic types and
+            strings natively, and any other type by its
+            representation.  A type overriding neither '_hash_'
+            nor '_repr_' always has the same representation, so
+            it is only hashed once.
+        */
+
+        if constexpr (Olly::has_override<T, capability::hash> || has_hash_value<T>) {
+            return _hash_(self(p));
+        }
+        else if constexpr (Olly::has_override<T, capability::repr>) {
+
+#if defined(OLLY_CACHED_TEXT)
+            if constexpr (text_cache_policy<T>::repr) {
+                /*
+                    Hash the cached representation, rather
+                    than writing it again for every hash.
+                */
+
+                writer_lease out;
+
+                out->boolalpha(true);
+
+                repr(p, *out);
+
+                return hash_value(out->view());
+            }
+#endif
+
+            return _hash_(self(p));
+        }
+        else {
+
+            static const std::size_t value = _hash_(self(p));
+
+            return value;
+        }
     }
 
     template <typename T>
-    var var::data_type<T>::_reverse() const {
-        return _reverse_(_data);
+    Text var::data_type<T>::help(const interface_type* p) {
+        return _help_(self(p));
     }
 
     template <typename T>
-    var var::data_type<T>::_get(var key) const {
-        return _get_(_data, key);
+    bool var::data_type<T>::is_nothing(const interface_type* p) {
+        return _is_nothing_(self(p));
     }
 
     template <typename T>
-    var var::data_type<T>::_set(var key, var val) const {
-        return _set_(_data, key, val);
+    OP_CODE var::data_type<T>::op_code(const interface_type* p) {
+        return _op_code_(self(p));
     }
 
+
+
+
+    /********************************************************************************************/
+    //
+    //                              Immediate Value Implementation
+    //
+    /********************************************************************************************/
+
     template <typename T>
-    var var::data_type<T>::_del(var key) const {
-        return _del_(_data, key);
+    bool var::encode(const T& x, std::uint64_t& word) {
+
+        if constexpr (std::is_same_v<T, nothing>) {
+            word = nothing_tag;
+        }
+        else if constexpr (std::is_same_v<T, bool>) {
+            word = bool_tag | static_cast<std::uint64_t>(x);
+        }
+        else if constexpr (std::is_same_v<T, int>) {
+            word = int_tag | static_cast<std::uint32_t>(x);
+        }
+        else if constexpr (std::is_same_v<T, long>) {
+
+            const long long limit = 1LL << 47;
+
+            if (x < -limit || x >= limit) {
+                return false;
+            }
+
+            word = long_tag | (static_cast<std::uint64_t>(x) & payload_mask);
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+
+            if (std::isnan(x)) {
+                word = canonical_nan;
+            }
+            else {
+                std::memcpy(&word, &x, sizeof(word));
+            }
+        }
+        else {
+            return false;
+        }
+
+        return true;
     }
 
     template <typename T>
-    Text var::data_type<T>::_help() const {
-        return _help_(_data);
+    bool var::holds() const {
+
+        if constexpr (std::is_same_v<T, nothing>) {
+            return _word == nothing_tag;
+        }
+        else if constexpr (std::is_same_v<T, bool>) {
+            return (_word & tag_mask) == bool_tag;
+        }
+        else if constexpr (std::is_same_v<T, int>) {
+            return (_word & tag_mask) == int_tag;
+        }
+        else if constexpr (std::is_same_v<T, long>) {
+            return (_word & tag_mask) == long_tag;
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+            return _word < nothing_tag;
+        }
+        else {
+            return false;
+        }
     }
 
     template <typename T>
-    bool var::data_type<T>::_is_nothing() const {
-        return _is_nothing_(_data);
+    T var::decode() const {
+
+        if constexpr (std::is_same_v<T, bool>) {
+            return (_word & payload_mask) != 0;
+        }
+        else if constexpr (std::is_same_v<T, int>) {
+            return static_cast<int>(static_cast<std::uint32_t>(_word));
+        }
+        else if constexpr (std::is_same_v<T, long>) {
+            return static_cast<long>(static_cast<std::int64_t>(_word << 16) >> 16);
+        }
+        else if constexpr (std::is_same_v<T, double>) {
+
+            double x;
+
+            std::memcpy(&x, &_word, sizeof(x));
+
+            return x;
+        }
+        else {
+            return T{};
+        }
+    }
+
+    bool var::is_boxed() const {
+        return (_word & tag_mask) == boxed_tag;
     }
 
     template <typename T>
-    OP_CODE var::data_type<T>::_op_code() const {
-        return _op_code_(_data);
+    const T* var::boxed() const {
+
+        const interface_type* p = pointer();
+
+        if (p && p->_type_id == type_registry::id<T>()) {
+            return &static_cast<const data_type<T>*>(p)->_data;
+        }
+
+        return nullptr;
+    }
+
+    var::interface_type* var::pointer() const {
+        /*
+            The boxed pointer, or a null pointer for immediate values.
+        */
+
+        if (!is_boxed()) {
+            return nullptr;
+        }
+
+        return reinterpret_cast<interface_type*>(static_cast<std::uintptr_t>(_word & payload_mask));
+    }
+
+    var::interface_type* var::owned() const {
+        return unique() ? pointer() : nullptr;
+    }
+
+    void var::retain() const {
+
+        if (is_boxed()) {
+
+#if defined(OLLY_INSTRUMENTATION)
+            ref_count_stats::retained();
+#endif
+
+            pointer()->_count.retain();
+        }
+    }
+
+    void var::release() {
+
+        if (is_boxed()) {
+
+#if defined(OLLY_INSTRUMENTATION)
+            ref_count_stats::released();
+#endif
+
+            interface_type* p = pointer();
+
+            if (p->_count.release(p)) {
+                dispose(p);
+            }
+        }
+
+        _word = nothing_tag;
+    }
+
+    var::interface_handle var::_interface() const {
+        return interface_handle(*this);
+    }
+
+    void dispose(const var::interface_type* p) {
+        p->_ops->destroy(p);
+    }
+
+    const var::interface_type* var::nothing_interface() {
+        /*
+            A single 'nothing' is shared by the whole process.  It is
+            constructed in static storage on first use and never
+            destroyed, so resolving an immediate 'nothing' never
+            allocates, copies or counts references.
+        */
+
+        alignas(data_type<nothing>) static unsigned char storage[sizeof(data_type<nothing>)];
+
+        static const interface_type* instance = new (storage) data_type<nothing>(nothing());
+
+        return instance;
+    }
+
+
+
+
+    /********************************************************************************************/
+    //
+    //                            'interface_handle' Class Implementation
+    //
+    /********************************************************************************************/
+
+    var::interface_handle::interface_handle(const var& n) : _ptr(n.pointer()) {
+
+        static_assert(sizeof(data_type<nothing>) <= sizeof(_buffer), "'nothing' must fit an immediate buffer.");
+        static_assert(sizeof(data_type<long>)    <= sizeof(_buffer), "'long' must fit an immediate buffer.");
+        static_assert(std::is_trivially_destructible_v<data_type<double>>, "Immediate values are never destroyed.");
+
+        if (n.is_boxed()) {
+            return;
+        }
+
+        if (n.holds<double>()) {
+            _ptr = new (_buffer) data_type<double>(n.decode<double>());
+        }
+        else if (n.holds<int>()) {
+            _ptr = new (_buffer) data_type<int>(n.decode<int>());
+        }
+        else if (n.holds<long>()) {
+            _ptr = new (_buffer) data_type<long>(n.decode<long>());
+        }
+        else if (n.holds<bool>()) {
+            _ptr = new (_buffer) data_type<bool>(n.decode<bool>());
+        }
+        else {
+            _ptr = nothing_interface();
+        }
+    }
+
+    const var::interface_type* var::interface_handle::operator->() const {
+        return _ptr;
     }
 
 
@@ -1288,47 +3849,87 @@ namespace Olly {
     //
     /********************************************************************************************/
 
-    Text str(var a) {
+    Text str(const var& a) {
         /*
             Convert a 'var' to its string representation.
         */
 
-        Text_Stream stream;
+        writer_lease stream;
 
-        stream << std::boolalpha;
+        stream->boolalpha(true);
 
-        if (a.type() == "format") {
+        static const Text& format = type_registry::intern("format");
+
+        if (&a.type() == &format) {
             /*
                 The 'format' data type must be printed using
                 its string representation, else it would only
                 impart its formatting to the stream instead of
-                being printed to it.
+                being printed to it.  Type names are interned,
+                so only their addresses need to be compared.
             */
-            a.repr(stream);
+            a.repr(*stream);
         }
         else {
-            a.str(stream);
+            a.str(*stream);
         }
 
-        return stream.str();
+        return stream->str();
     }
 
-    Text repr(var a) {
+    Text repr(const var& a) {
         /*
             Convert a 'var' to its representation as a string.
         */
 
-        Text_Stream stream;
+        writer_lease stream;
+
+        stream->boolalpha(true);
+
+        a.repr(*stream);
+
+        return stream->str();
+    }
+
+    void stream_str(const var& a, text_sink sink, std::size_t chunk_size) {
+        /*
+            Stream a 'var' as 'str' would convert it, holding no
+            more than a chunk of its text at a time.
+        */
+
+        text_writer stream(sink, chunk_size);
+
+        stream.boolalpha(true);
+
+        static const Text& format = type_registry::intern("format");
+
+        if (&a.type() == &format) {
+            a.repr(stream);
+        }
+        else {
+            a.str(stream);
+        }
+
+        stream.flush();
+    }
+
+    void stream_repr(const var& a, text_sink sink, std::size_t chunk_size) {
 
-        stream << std::boolalpha;
+        text_writer stream(sink, chunk_size);
+
+        stream.boolalpha(true);
 
         a.repr(stream);
 
-        return stream.str();
+        stream.flush();
     }
 
     var pop_lead(var& exp) {
 
+        if (exp.is_nothing()) {
+            return exp;
+        }
+
         var a = exp.lead();
 
         exp = exp.next();
@@ -1338,10 +3939,47 @@ namespace Olly {
 
     var pop_last(var& exp) {
 
+        if (exp.is_nothing()) {
+            return exp;
+        }
+
         var a = exp.last();
 
         exp = exp.prev();
 
         return a;
     }
+}
+
+namespace std {
+
+    template <>
+    struct hash<Olly::var> {   // Allows a 'var' to key the unordered containers.
+
+        std::size_t operator()(const Olly::var& n) const {
+            return n.hash();
+        }
+    };
+
+#if defined(__cpp_lib_format)
+    template <>
+    struct formatter<Olly::var, char> : formatter<string_view, char> {  // Allows 'std::format("{}", n)'.
+
+        template <typename Context>
+        auto format(const Olly::var& n, Context& ctx) const {
+            /*
+                Write into a pooled buffer, then apply the width,
+                fill and alignment of the string formatter.
+            */
+
+            Olly::writer_lease out;
+
+            out->boolalpha(true);
+
+            n.str(*out);
+
+            return formatter<string_view, char>::format(out->view(), ctx);
+        }
+    };
+#endif
 }
\ No newline at end of file